@@ -3,6 +3,7 @@
 import spot
 import pandas as pd
 import subprocess
+import ctypes
 from functools import lru_cache
 from spot import op_F,op_G,op_U,op_R,op_X,op_And,op_Or,op_tt,op_ff
 
@@ -122,6 +123,49 @@ def get_states_number(command,formula):
     return ret
 
     
+class Ltl3tela:
+    '''Translates formulae in-process using `libltl3tela.so`
+    (build it by `make libltl3tela.so`) instead of running
+    `ltl3tela` for each formula.'''
+    HOA = 0
+    STATS = 1
+
+    def __init__(self, path='libltl3tela.so'):
+        self.lib = ctypes.CDLL(path)
+        self.lib.ltl3tela_translate.argtypes = [ctypes.c_char_p, ctypes.c_char_p,
+                                                ctypes.c_int, ctypes.POINTER(ctypes.c_void_p)]
+        self.lib.ltl3tela_translate.restype = ctypes.c_int
+        self.lib.ltl3tela_free.argtypes = [ctypes.c_void_p]
+        self.lib.ltl3tela_version.restype = ctypes.c_char_p
+
+    def version(self):
+        return self.lib.ltl3tela_version().decode('utf-8')
+
+    def _call(self, formula, flags, what):
+        result = ctypes.c_void_p()
+        ret = self.lib.ltl3tela_translate(formula.encode('utf-8'), flags.encode('utf-8'),
+                                          what, ctypes.byref(result))
+        out = ctypes.string_at(result).decode('utf-8')
+        self.lib.ltl3tela_free(result)
+        if ret:
+            raise RuntimeError('ltl3tela returned {}: {}'.format(ret, out))
+        return out
+
+    def translate(self, formula, flags=''):
+        '''Returns the automaton for `formula` in HOA.'''
+        return self._call(formula, flags, self.HOA)
+
+    def stats(self, formula, flags=''):
+        '''Returns a dict with the keys `states`, `edges`, `acc-sets`
+        and `deterministic` of the automaton for `formula`.'''
+        out = self._call(formula, flags, self.STATS)
+        res = {}
+        for line in out.splitlines()[:4]:
+            key, value = line.split(': ')
+            res[key] = int(value)
+        return res
+
+
 def compute_results(formulas,toolnames,tools):
     '''Runs each tool from `toolnames` on each formula from `formulas`
     and stores the results in a pandas DataFrame, which is returned.'''
@@ -37,8 +37,6 @@ unsigned get_max_u_disj_size(spot::formula f) {
 	return max;
 }
 
-unsigned max_u_disj_size;
-
 bool is_mergeable(SLAA* slaa, spot::formula f) {
 	if (!f.is(spot::op::U)) {
 		throw "Argument of is_mergeable is not an U-formula";
@@ -127,10 +125,7 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 				conj_edges.insert(slaa->get_state_edges(make_alternating_recursive(slaa, f[i])));
 			}
 			// and add the product edges
-			auto product = slaa->product(conj_edges, true);
-			for (auto& edge : product) {
-				slaa->add_edge(state_id, edge);
-			}
+			slaa->add_product(state_id, conj_edges, true);
 		} else if (f.is(spot::op::Or)) {
 			// create a state for each disjunct
 			bdd state_labels_disj = bddfalse;
@@ -149,7 +144,7 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 				bdd this_state_labels = bddfalse;
 				if (o_disj_merging && same_labels) {
 					for (auto edge_id : fi_state_edges) {
-						auto targets = slaa->get_edge(edge_id)->get_targets();
+						const auto& targets = slaa->get_edge(edge_id)->get_targets();
 						if (std::find(std::begin(targets), std::end(targets), fi_st_id) != std::end(targets)) {
 							this_state_labels = bdd_or(this_state_labels, slaa->get_edge(edge_id)->get_label());
 							if (targets.size() > 1) {
@@ -331,14 +326,11 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 				}
 
 				// create a product of all new edges
-				auto phi_product = slaa->product(edges_for_product, true);
-				for (auto edge_id : phi_product) {
-					slaa->add_edge(state_id, edge_id);
-				}
+				slaa->add_product(state_id, edges_for_product, true);
 			} else {
 				// use traditional construction
-				std::set<unsigned> left_edges = slaa->get_state_edges(left);
-				std::set<unsigned> right_edges = slaa->get_state_edges(right);
+				const auto& left_edges = slaa->get_state_edges(left);
+				const auto& right_edges = slaa->get_state_edges(right);
 
 				unsigned loop_id = slaa->create_edge(bdd_true());
 				slaa->get_edge(loop_id)->add_target(state_id);
@@ -409,7 +401,7 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 						if (o_u_merge_level == 3) {
 							// we won't merge if there is a looping alternating transition
 							for (auto& edge_id : product_edges) {
-								auto edge_targets = slaa->get_edge(edge_id)->get_targets();
+								const auto& edge_targets = slaa->get_edge(edge_id)->get_targets();
 
 								if (edge_targets.count(product_state) > 0 && edge_targets.size() >= 2) {
 									merge = false;
@@ -433,7 +425,7 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 							mark = ac.add_sets(f_dnf_size);
 						} else {
 							if (ac.num_sets() == 1) {
-								auto _x = ac.add_sets(max_u_disj_size);
+								auto _x = ac.add_sets(slaa->max_u_disj_size);
 								if (_x != 1) {
 									throw "Disjunction Fin marks are expected to start at 1.";
 								}
@@ -441,7 +433,7 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 							mark = 1;
 						}
 
-						for (acc_mark i = mark; i < mark + (o_g_merge_level ? f_dnf_size : max_u_disj_size); ++i) {
+						for (acc_mark i = mark; i < mark + (o_g_merge_level ? f_dnf_size : slaa->max_u_disj_size); ++i) {
 							if (acc_empty || o_g_merge_level) {
 								slaa->acc[f].fin_disj.insert(i);
 							}
@@ -469,7 +461,7 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 					if (o_u_merge_level == 3) {
 						// we won't merge if there is a looping alternating transition
 						for (auto& edge_id : product_edges) {
-							auto edge_targets = slaa->get_edge(edge_id)->get_targets();
+							const auto& edge_targets = slaa->get_edge(edge_id)->get_targets();
 								if (edge_targets.count(product_state) > 0 && edge_targets.size() >= 2) {
 								merge = false;
 								break;
@@ -495,7 +487,7 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 
 							auto new_edge_marks = edge->get_marks();
 							if (mark != -1U) {
-								for (unsigned i = mark; i < mark + (o_g_merge_level ? f_dnf_size : max_u_disj_size); ++i) {
+								for (unsigned i = mark; i < mark + (o_g_merge_level ? f_dnf_size : slaa->max_u_disj_size); ++i) {
 									if (i != m_mark) {
 										new_edge_marks.insert(i);
 									}
@@ -513,8 +505,8 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 				}
 			} else {
 				// the classical construction for U
-				std::set<unsigned> left_edges = slaa->get_state_edges(left);
-				std::set<unsigned> right_edges = slaa->get_state_edges(right);
+				const auto& left_edges = slaa->get_state_edges(left);
+				const auto& right_edges = slaa->get_state_edges(right);
 
 				unsigned loop_id = slaa->create_edge(bdd_true());
 				slaa->get_edge(loop_id)->add_target(state_id);
@@ -545,28 +537,34 @@ unsigned make_alternating_recursive(SLAA* slaa, spot::formula f) {
 SLAA* make_alternating(spot::formula f, spot::bdd_dict_ptr dict) {
 	SLAA* slaa = new SLAA(f, dict);
 
-	max_u_disj_size = get_max_u_disj_size(f);
-
-	if (o_single_init_state) {
-		std::set<unsigned> init_set = { make_alternating_recursive(slaa, f) };
-		slaa->add_init_set(init_set);
-	} else {
-		std::set<std::set<spot::formula>> f_dnf = f_bar(f);
+	// f_bar and the products may be cut off by the deadline
+	try {
+		slaa->max_u_disj_size = get_max_u_disj_size(f);
 
-		for (auto& g_set : f_dnf) {
-			std::set<unsigned> init_set;
-			for (auto& g : g_set) {
-				unsigned init_state_id = make_alternating_recursive(slaa, g);
-				init_set.insert(init_state_id);
-			}
+		if (o_single_init_state) {
+			std::set<unsigned> init_set = { make_alternating_recursive(slaa, f) };
 			slaa->add_init_set(init_set);
+		} else {
+			std::set<std::set<spot::formula>> f_dnf = f_bar(f);
+
+			for (auto& g_set : f_dnf) {
+				std::set<unsigned> init_set;
+				for (auto& g : g_set) {
+					unsigned init_state_id = make_alternating_recursive(slaa, g);
+					init_set.insert(init_state_id);
+				}
+				slaa->add_init_set(init_set);
+			}
 		}
-	}
 
-	slaa->build_acc();
+		slaa->build_acc();
 
-	if (o_slaa_determ == 2) {
-		slaa->apply_extended_domination();
+		if (o_slaa_determ == 2) {
+			slaa->apply_extended_domination();
+		}
+	} catch (...) {
+		delete slaa;
+		throw;
 	}
 
 	return slaa;
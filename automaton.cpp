@@ -20,11 +20,42 @@
 #include "automaton.hpp"
 
 template class Automaton<spot::formula>;
-template class Automaton<unsigned>;
+
+// the number of edges allocated by all automata and its maximum
+static unsigned long live_edges = 0;
+static unsigned long peak_edges = 0;
+
+unsigned long edges_peak() {
+	return peak_edges;
+}
+
+void reset_edges_peak() {
+	peak_edges = live_edges;
+}
+
+// the number of edges added with the domination check and the number
+// of calls of Edge::dominates they needed
+static unsigned long checked_insertions = 0;
+static unsigned long dominance_checks = 0;
+
+unsigned long domination_insertions() {
+	return checked_insertions;
+}
+
+unsigned long domination_checks() {
+	return dominance_checks;
+}
+
+void reset_domination_stats() {
+	checked_insertions = 0;
+	dominance_checks = 0;
+}
 
 // Print handler for bdd_allsat
 // Taken from LTL3BA source: https://sourceforge.net/projects/ltl3ba/
-bool print_or = false;
+static bool print_or = false;
+// maps the BDD variables to the AP indices of the printed automaton
+static const std::map<int, unsigned>* print_ap_index = nullptr;
 void allsatPrintHandler(char* varset, int size) {
 	if (print_or) {
 		std::cout << " | ";
@@ -43,7 +74,7 @@ void allsatPrintHandler(char* varset, int size) {
 		if (varset[v] == 0) {
 			std::cout << "!";
 		}
-		std::cout << v;
+		std::cout << print_ap_index->at(v);
 		print_and = true;
 	}
 	if (!print_and) {
@@ -54,12 +85,27 @@ void allsatPrintHandler(char* varset, int size) {
 	print_or = true;
 }
 
+std::map<int, unsigned> hoaf_ap_index(const spot::const_twa_ptr& aut) {
+	std::map<int, unsigned> ap_index;
+	const auto& aps = aut->ap();
+	for (unsigned i = 0; i < aps.size(); ++i) {
+		ap_index[aut->get_dict()->varnum(aps[i])] = i;
+	}
+
+	return ap_index;
+}
+
+void print_label_hoaf(bdd label, const std::map<int, unsigned>& ap_index) {
+	print_or = false;
+	print_ap_index = &ap_index;
+	bdd_allsat(label, allsatPrintHandler);
+}
+
 template<typename T> unsigned Automaton<T>::get_state_id(T f) {
 	unsigned size = states.size();
-	for (unsigned i = 0; i < size; ++i) {
-		if (states[i] == f) {
-			return i;
-		}
+	auto inserted = state_index.emplace(f, size);
+	if (!inserted.second) {
+		return inserted.first->second;
 	}
 
 	states.push_back(f);
@@ -72,7 +118,7 @@ template<typename T> T Automaton<T>::state_name(unsigned state_id) {
 }
 
 template<typename T> bool Automaton<T>::state_exists(T f) {
-	return find(states.begin(), states.end(), f) != states.end();
+	return state_index.count(f) > 0;
 }
 
 template<typename T> unsigned Automaton<T>::states_count() {
@@ -80,13 +126,61 @@ template<typename T> unsigned Automaton<T>::states_count() {
 }
 
 template<typename T> unsigned Automaton<T>::create_edge(bdd label) {
-	auto e = new Edge(label);
-	edges.push_back(e);
+	edge_pool.emplace_back(label);
+	edges.push_back(&edge_pool.back());
+
+	if (++live_edges > peak_edges) {
+		peak_edges = live_edges;
+	}
 
 	return edges.size() - 1;
 }
 
-template<typename T> void Automaton<T>::add_edge(unsigned from, bdd label, std::set<unsigned> to, std::set<acc_mark> marks) {
+template<typename T> void Automaton<T>::compact_edges() {
+	std::vector<bool> used(edges.size(), false);
+	for (auto& edge_ids : state_edges) {
+		for (auto edge_id : edge_ids) {
+			used[edge_id] = true;
+		}
+	}
+
+	// assign the new IDs in the order of the old ones so that
+	// the iteration order of state_edges does not change
+	std::vector<unsigned> new_id(edges.size(), -1U);
+	std::deque<Edge> new_pool;
+	std::vector<Edge*> new_edges;
+
+	for (unsigned edge_id = 0; edge_id < edges.size(); ++edge_id) {
+		if (used[edge_id]) {
+			new_id[edge_id] = new_edges.size();
+			new_pool.push_back(std::move(*edges[edge_id]));
+			new_edges.push_back(&new_pool.back());
+		}
+	}
+
+	for (auto& edge_ids : state_edges) {
+		std::set<unsigned> new_edge_ids;
+		for (auto edge_id : edge_ids) {
+			new_edge_ids.insert(new_edge_ids.end(), new_id[edge_id]);
+		}
+		edge_ids.swap(new_edge_ids);
+	}
+
+	for (auto it = edge_index.begin(); it != edge_index.end(); /* NOP */) {
+		if (used[it->second]) {
+			it->second = new_id[it->second];
+			++it;
+		} else {
+			it = edge_index.erase(it);
+		}
+	}
+
+	live_edges -= edges.size() - new_edges.size();
+	edge_pool.swap(new_pool);
+	edges.swap(new_edges);
+}
+
+template<typename T> void Automaton<T>::add_edge(unsigned from, bdd label, target_set to, mark_set marks) {
 	if (label == bddfalse) {
 		return;
 	}
@@ -95,38 +189,50 @@ template<typename T> void Automaton<T>::add_edge(unsigned from, bdd label, std::
 
 	Edge* e_this = get_edge(edge_id);
 
-	e_this->add_target(to);
+	e_this->replace_target_set(std::move(to));
 	e_this->add_mark(marks);
 
-	// the domination of transitions
-	// we always do this for NA
-	if (o_slaa_determ || spot_id_to_slaa_set != nullptr) {
-		std::set<unsigned> edges_to_add;
+	if (o_slaa_determ) {
+		// the domination of transitions
+		add_dominating_edge(from, edge_id);
+	} else {
+		insert_edge(from, edge_id);
+	}
+}
+
+template<typename T> void Automaton<T>::add_dominating_edge(unsigned from, unsigned edge_id) {
+	++checked_insertions;
+
+	// the edges waiting to be added; the last one is processed first
+	std::vector<unsigned> pending = { edge_id };
+
+	while (!pending.empty()) {
+		edge_id = pending.back();
+		pending.pop_back();
+
+		auto e_this = get_edge(edge_id);
+		if (e_this->get_label() == bddfalse) {
+			continue;
+		}
+
+		// copies of the edges partially dominated by e_this, relabeled
+		std::vector<unsigned> edges_to_add;
+		bool merged = false;
+
 		// we look at all other edges and check if the new edge dominates the other
 		// NOP in the increment part as we sometimes increment the iterator with erase
 		for (auto e_other_it = state_edges[from].begin(); e_other_it != state_edges[from].end(); /* NOP */) {
 			auto e_other = get_edge(*e_other_it);
 
-			int dom_level;
-			if constexpr (!std::is_same<T, unsigned>::value) {
-				dom_level = e_this->dominates(e_other, get_inf_marks());
-			} else {
-				dom_level = e_this->dominates(e_other,
-					(*spot_id_to_slaa_set)[state_name(*(e_this->get_targets().begin()))],
-					(*spot_id_to_slaa_set)[state_name(*(e_other->get_targets().begin()))],
-					get_inf_marks()
-				);
-			}
-			switch (dom_level) {
+			++dominance_checks;
+			switch (e_this->dominates(e_other, get_inf_marks())) {
 				case 1:
 					// we are adding an edge that is equal in its targets and mark sets to e_other
 					// remove e_other and add an edge labeled a1 | a2
 					e_this->set_label(e_this->get_label() | e_other->get_label());
 					state_edges[from].erase(e_other_it);
-					add_edge(from, edge_id);
-
-					add_edge(from, edges_to_add);
-					return;
+					merged = true;
+				break;
 				case 2: {
 					// we relabel each dominating edge
 					// copy e_other and add it later
@@ -135,7 +241,7 @@ template<typename T> void Automaton<T>::add_edge(unsigned from, bdd label, std::
 					f->add_target(e_other->get_targets());
 					f->add_mark(e_other->get_marks());
 
-					edges_to_add.insert(f_id);
+					edges_to_add.push_back(f_id);
 				}
 				// no break
 				case 3:
@@ -144,46 +250,121 @@ template<typename T> void Automaton<T>::add_edge(unsigned from, bdd label, std::
 				default:
 					++e_other_it;
 			}
+
+			if (merged) {
+				break;
+			}
+		}
+
+		// the copies are added in the order they were created
+		pending.insert(pending.end(), edges_to_add.rbegin(), edges_to_add.rend());
+
+		if (merged) {
+			// the merged edge is checked again before the copies
+			pending.push_back(edge_id);
+			continue;
 		}
 
 		// now we check if there exists some other edge that dominates our edge
+		bool killed = false;
 		for (auto& e_other_id : state_edges[from]) {
 			auto e_other = get_edge(e_other_id);
-			int dom_level;
-			if constexpr (!std::is_same<T, unsigned>::value) {
-				dom_level = e_other->dominates(e_this, get_inf_marks());
-			} else {
-				dom_level = e_other->dominates(e_this,
-					(*spot_id_to_slaa_set)[state_name(*(e_other->get_targets().begin()))],
-					(*spot_id_to_slaa_set)[state_name(*(e_this->get_targets().begin()))],
-					get_inf_marks()
-				);
-			}
-			switch (dom_level) {
+
+			++dominance_checks;
+			switch (e_other->dominates(e_this, get_inf_marks())) {
 				case 3:
 					// do not add
 					// the new edge is killed by the existing edge
-					add_edge(from, edges_to_add);
-					return;
+					killed = true;
+				break;
 				case 2:
 					// relabel the new edge
 					e_this->set_label(e_this->get_label() & bdd_not(e_other->get_label()));
 				// case 1 would happen in the previous for loop
 			}
+
+			if (killed) {
+				break;
+			}
 		}
 
-		add_edge(from, edges_to_add);
+		if (!killed) {
+			insert_edge(from, edge_id);
+		}
+	}
+}
+
+template<typename T> void Automaton<T>::insert_edge(unsigned from, unsigned edge_id) {
+	// use an equal edge if some state already has it
+	auto h = edges[edge_id]->hash();
+	auto equal_id = find_equal_edge(edge_id, h);
+	if (equal_id != -1U) {
+		edge_id = equal_id;
+	} else {
+		edge_index.emplace(h, edge_id);
 	}
 
 	state_edges[from].insert(edge_id);
 }
 
+template<typename T> unsigned Automaton<T>::find_equal_edge(unsigned edge_id, size_t h) const {
+	auto range = edge_index.equal_range(h);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (*edges[it->second] == *edges[edge_id]) {
+			return it->second;
+		}
+	}
+
+	return -1U;
+}
+
+template<typename T> void Automaton<T>::share_edges() {
+	edge_index.clear();
+
+	for (auto& edge_ids : state_edges) {
+		std::set<unsigned> new_edge_ids;
+		for (auto edge_id : edge_ids) {
+			auto h = edges[edge_id]->hash();
+			auto equal_id = find_equal_edge(edge_id, h);
+			if (equal_id != -1U) {
+				new_edge_ids.insert(equal_id);
+			} else {
+				edge_index.emplace(h, edge_id);
+				new_edge_ids.insert(edge_id);
+			}
+		}
+		edge_ids.swap(new_edge_ids);
+	}
+}
+
+template<typename T> void Automaton<T>::unshare_edges() {
+	edge_index.clear();
+
+	// the first state using an edge keeps it, the others get a copy
+	std::vector<bool> owned(edges.size(), false);
+	for (auto& edge_ids : state_edges) {
+		std::set<unsigned> new_edge_ids;
+		for (auto edge_id : edge_ids) {
+			if (!owned[edge_id]) {
+				owned[edge_id] = true;
+				new_edge_ids.insert(edge_id);
+			} else {
+				auto copy_id = create_edge(edges[edge_id]->get_label());
+				edges[copy_id]->replace_target_set(edges[edge_id]->get_targets());
+				edges[copy_id]->add_mark(edges[edge_id]->get_marks());
+				new_edge_ids.insert(copy_id);
+			}
+		}
+		edge_ids.swap(new_edge_ids);
+	}
+}
+
 template<typename T> void Automaton<T>::add_edge(unsigned from, unsigned edge_id) {
 	auto orig = edges[edge_id];
 	add_edge(from, orig->get_label(), orig->get_targets(), orig->get_marks());
 }
 
-template<typename T> void Automaton<T>::add_edge(unsigned from, std::set<unsigned> edge_ids) {
+template<typename T> void Automaton<T>::add_edge(unsigned from, const std::set<unsigned>& edge_ids) {
 	for (auto& edge_id : edge_ids) {
 		add_edge(from, edge_id);
 	}
@@ -193,7 +374,7 @@ template<typename T> void Automaton<T>::remove_edge(unsigned state_id, unsigned
 	state_edges[state_id].erase(edge_id);
 }
 
-template<typename T> std::set<acc_mark> Automaton<T>::get_inf_marks() const {
+template<typename T> const mark_set& Automaton<T>::get_inf_marks() const {
 	return inf_marks;
 }
 
@@ -201,38 +382,29 @@ template<typename T> void Automaton<T>::remember_inf_mark(acc_mark mark) {
 	inf_marks.insert(mark);
 }
 
-template<typename T> void Automaton<T>::remember_inf_mark(std::set<acc_mark> marks) {
-	inf_marks.insert(marks.begin(), marks.end());
+template<typename T> void Automaton<T>::remember_inf_mark(const mark_set& marks) {
+	inf_marks.insert(marks);
 }
 
-std::set<std::set<unsigned>> SLAA::get_init_sets() const {
+const std::set<std::set<unsigned>>& SLAA::get_init_sets() const {
 	return init_sets;
 }
 
-void SLAA::add_init_set(std::set<unsigned> init_set) {
+void SLAA::add_init_set(const std::set<unsigned>& init_set) {
 	init_sets.insert(init_set);
 }
 
-unsigned NA::get_init_state() const {
-	return *(init_sets.begin()->begin());
-}
-
-void NA::set_init_state(unsigned s) {
-	init_sets = { { s } };
-}
-
 template<typename T> Edge* Automaton<T>::get_edge(unsigned edge_id) const {
 	return edges[edge_id];
 }
 
-template<typename T> std::set<unsigned> Automaton<T>::get_state_edges(unsigned state_id) const {
+template<typename T> const std::set<unsigned>& Automaton<T>::get_state_edges(unsigned state_id) const {
 	assert(state_edges.size() > state_id);
 	return state_edges[state_id];
 }
 
 template<typename T> unsigned Automaton<T>::edge_product(unsigned e1, unsigned e2, bool preserve_ixsets) {
-	auto e = new Edge(edges[e1]->get_label() & edges[e2]->get_label());
-	edges.push_back(e);
+	auto e = get_edge(create_edge(edges[e1]->get_label() & edges[e2]->get_label()));
 	e->add_target(edges[e1]->get_targets());
 	e->add_target(edges[e2]->get_targets());
 
@@ -244,38 +416,73 @@ template<typename T> unsigned Automaton<T>::edge_product(unsigned e1, unsigned e
 	return edges.size() - 1;
 }
 
-// returns a set of edges in the product
-template<typename T> std::set<unsigned> Automaton<T>::product(std::set<std::set<unsigned>> edges_sets, bool preserve_ixsets) {
+// adds the products to the source state as they are enumerated
+void SLAA::add_product(unsigned from, const std::set<std::set<unsigned>>& edges_sets, bool preserve_ixsets) {
 	if (edges_sets.empty()) {
 		// this is not a correct value for product of empty set
 		// in NA, a ∅ state is true and should contain a loop
 		// however, a source state is not an argument of product
 		// so we have to handle this outside of this method
-		return std::set<unsigned>();
+		return;
 	}
 
-	auto s0 = *(edges_sets.begin());
+	if (edges_sets.size() > 1) {
+		check_deadline("product");
+	}
 
-	if (edges_sets.size() == 1) {
-		return s0;
+	std::vector<const std::set<unsigned>*> factors;
+	for (auto& edges_set : edges_sets) {
+		factors.push_back(&edges_set);
 	}
 
-	edges_sets.erase(edges_sets.begin());
-	auto s1 = product(edges_sets, preserve_ixsets);
+	// the depth-first search over the choices of one edge from each factor;
+	// level i holds the label, targets and marks of the product of the
+	// edges chosen in the first i factors
+	unsigned n = factors.size();
+	std::vector<std::set<unsigned>::const_iterator> choice(n);
+	std::vector<bdd> labels(n + 1);
+	std::vector<target_set> targets(n + 1);
+	std::vector<mark_set> marks(n + 1);
+
+	labels[0] = bdd_true();
+	choice[0] = factors[0]->begin();
+	unsigned level = 0;
+
+	while (true) {
+		if (choice[level] == factors[level]->end()) {
+			if (level == 0) {
+				break;
+			}
 
-	std::set<unsigned> result;
+			--level;
+			++choice[level];
+			continue;
+		}
 
-	for (auto& e0 : s0) {
-		for (auto& e1 : s1) {
+		auto e = edges[*choice[level]];
 
-			unsigned p = edge_product(e0, e1, preserve_ixsets);
-			if (get_edge(p)->get_label() != bdd_false()) {
-				result.insert(p);
-			}
+		// no product containing this partial one can have a satisfiable label
+		labels[level + 1] = labels[level] & e->get_label();
+		if (labels[level + 1] == bddfalse) {
+			++choice[level];
+			continue;
 		}
-	}
 
-	return result;
+		targets[level + 1] = targets[level];
+		targets[level + 1].insert(e->get_targets());
+
+		if (preserve_ixsets) {
+			marks[level + 1] = marks[level] | e->get_marks();
+		}
+
+		if (level + 1 == n) {
+			add_edge(from, labels[n], targets[n], marks[n]);
+			++choice[level];
+		} else {
+			++level;
+			choice[level] = factors[level]->begin();
+		}
+	}
 }
 
 void SLAA::build_acc() {
@@ -336,7 +543,11 @@ std::set<std::set<acc_mark>> SLAA::get_minimal_models_of_acc_cond() const {
 }
 
 void SLAA::apply_extended_domination() {
-	const auto& mm = get_minimal_models_of_acc_cond();
+	// the labels are restricted for each state separately
+	unshare_edges();
+
+	const auto& mm_sets = get_minimal_models_of_acc_cond();
+	const std::vector<mark_set> mm(mm_sets.begin(), mm_sets.end());
 	for (unsigned state_id = 0, states_count = states.size(); state_id < states_count; ++state_id) {
 		for (auto e1_id : state_edges[state_id]) {
 			auto e1 = get_edge(e1_id);
@@ -349,11 +560,11 @@ void SLAA::apply_extended_domination() {
 
 				auto e2 = get_edge(*e2_it);
 
-				auto o1 = e1->get_targets();
-				auto o2 = e2->get_targets();
+				const auto& o1 = e1->get_targets();
+				const auto& o2 = e2->get_targets();
 
-				auto j1 = e1->get_marks();
-				auto j2 = e2->get_marks();
+				const auto& j1 = e1->get_marks();
+				const auto& j2 = e2->get_marks();
 
 				// e1 dominates e2 iff
 				// 1. e1.targets ⊆ e2.targets
@@ -361,37 +572,17 @@ void SLAA::apply_extended_domination() {
 				// 2a. M ∩ Fin(Φ) ∩ e2.marks = ∅ => M ∩ Fin(Φ) ∩ e1.marks = ∅
 				// 2b. M ∩ Inf(Φ) ∩ e1.marks = ∅ => M ∩ Inf(Φ) ∩ e2.marks = ∅
 				bool dominates = false;
-				if (std::includes(std::begin(o2), std::end(o2), std::begin(o1), std::end(o1))) { // condition (1) holds
-					const auto& inf_marks = get_inf_marks();
-
+				if (o1.subset_of(o2)) { // condition (1) holds
 					dominates = true; // we may rewrite this again later
 
 					for (const auto& model : mm) {
-						std::set<acc_mark> m_e1;
-						std::set<acc_mark> m_e2;
-						std::set_intersection(std::begin(model), std::end(model), std::begin(j1), std::end(j1), std::inserter(m_e1, std::begin(m_e1)));
-						std::set_intersection(std::begin(model), std::end(model), std::begin(j2), std::end(j2), std::inserter(m_e2, std::begin(m_e2)));
-
-						bool m_fin_in_e1 = false;
-						bool m_fin_in_e2 = false;
-						bool m_inf_in_e1 = false;
-						bool m_inf_in_e2 = false;
-
-						for (auto i : m_e1) {
-							if (std::find(std::begin(inf_marks), std::end(inf_marks), i) == std::end(inf_marks)) {
-								m_fin_in_e1 = true;
-							} else {
-								m_inf_in_e1 = true;
-							}
-						}
+						auto m_e1 = model & j1;
+						auto m_e2 = model & j2;
 
-						for (auto i : m_e2) {
-							if (std::find(std::begin(inf_marks), std::end(inf_marks), i) == std::end(inf_marks)) {
-								m_fin_in_e2 = true;
-							} else {
-								m_inf_in_e2 = true;
-							}
-						}
+						bool m_fin_in_e1 = !(m_e1 - inf_marks).empty();
+						bool m_fin_in_e2 = !(m_e2 - inf_marks).empty();
+						bool m_inf_in_e1 = !(m_e1 & inf_marks).empty();
+						bool m_inf_in_e2 = !(m_e2 & inf_marks).empty();
 
 						if (!m_fin_in_e2 && m_fin_in_e1 || !m_inf_in_e1 && m_inf_in_e2) {
 							dominates = false;
@@ -441,19 +632,30 @@ template<typename T> void Automaton<T>::remove_unreachable_states() {
 			}
 			new_init_set.insert(conversion_table[init_state]);
 		}
-		new_init_sets.insert(new_init_set);
+		new_init_sets.insert(std::move(new_init_set));
 	}
 
-	init_sets = new_init_sets;
+	init_sets = std::move(new_init_sets);
+
+	// the targets change, so the hashes of the indexed edges do as well
+	edge_index.clear();
+
+	// an edge shared by more states is converted only once
+	std::vector<bool> converted(edges.size(), false);
 
 	while (!bfs_queue.empty()) {
 		unsigned state_id = bfs_queue.front();
 		bfs_queue.pop();
 
 		for (auto& edge_id : get_state_edges(state_id)) {
+			if (converted[edge_id]) {
+				continue;
+			}
+			converted[edge_id] = true;
+
 			auto edge = get_edge(edge_id);
-			auto targets = edge->get_targets();
-			std::set<unsigned> new_target_set;
+			const auto& targets = edge->get_targets();
+			target_set new_target_set;
 			for (auto& target_id : targets) {
 				unsigned new_target_id;
 				if (conversion_table.count(target_id) == 0) {
@@ -469,7 +671,7 @@ template<typename T> void Automaton<T>::remove_unreachable_states() {
 				new_target_set.insert(new_target_id);
 			}
 			// we replace target IDs with converted ones
-			edge->replace_target_set(new_target_set);
+			edge->replace_target_set(std::move(new_target_set));
 		}
 	}
 
@@ -484,20 +686,27 @@ template<typename T> void Automaton<T>::remove_unreachable_states() {
 		new_state_edges_table[rec.second] = state_edges[rec.first];
 	}
 
-	states = new_state_table;
-	state_edges = new_state_edges_table;
+	states = std::move(new_state_table);
+	state_edges = std::move(new_state_edges_table);
+
+	state_index.clear();
+	for (unsigned state_id = 0; state_id < conv_table_size; ++state_id) {
+		state_index.emplace(states[state_id], state_id);
+	}
+
+	// free the edges of removed states and those replaced during the construction
+	compact_edges();
 }
 
-void SLAA::add_edge(unsigned from, bdd label, std::set<unsigned> to, std::set<acc_mark> marks) {
-	std::set<unsigned> to_(to);
+void SLAA::add_edge(unsigned from, bdd label, target_set to, mark_set marks) {
 	for (auto& kv : dom_states) {
-		if (to_.find(kv.first) != std::end(to_)) {
+		if (to.find(kv.first) != std::end(to)) {
 			for (auto& s : kv.second) {
-				to_.erase(s);
+				to.erase(s);
 			}
 		}
 	}
-	Automaton<spot::formula>::add_edge(from, label, to_, marks);
+	Automaton<spot::formula>::add_edge(from, label, std::move(to), marks);
 }
 
 void SLAA::add_edge(unsigned from, unsigned edge_id) {
@@ -505,7 +714,7 @@ void SLAA::add_edge(unsigned from, unsigned edge_id) {
 	add_edge(from, orig->get_label(), orig->get_targets(), orig->get_marks());
 }
 
-void SLAA::add_edge(unsigned from, std::set<unsigned> edge_ids) {
+void SLAA::add_edge(unsigned from, const std::set<unsigned>& edge_ids) {
 	for (auto& edge_id : edge_ids) {
 		add_edge(from, edge_id);
 	}
@@ -513,6 +722,9 @@ void SLAA::add_edge(unsigned from, std::set<unsigned> edge_ids) {
 
 // removes all marks on non-loops
 void SLAA::remove_unnecessary_marks() {
+	// whether an edge is a loop depends on the state
+	unshare_edges();
+
 	for (unsigned state_id = 0, states_count = states.size(); state_id < states_count; ++state_id) {
 		for (auto& edge_id : state_edges[state_id]) {
 			// check if this is not a loop
@@ -538,6 +750,9 @@ SLAA::ac_representation SLAA::mark_transformation(std::map<acc_mark, unsigned>&
 		}
 	}
 
+	// the marks are renamed for each state separately
+	unshare_edges();
+
 	// map of escaping marks
 	std::map<acc_mark, acc_mark> sibling_of;
 
@@ -686,6 +901,34 @@ void SLAA::register_dom_states(unsigned strong, unsigned weak, unsigned option_l
 	}
 }
 
+frozen_slaa SLAA::freeze() const {
+	frozen_slaa frozen;
+
+	// rank the distinct sets of edges in their order in std::set,
+	// so that the products are computed in the same order as by product
+	std::map<std::set<unsigned>, unsigned> ranks;
+	for (auto& state_edge_ids : state_edges) {
+		ranks.emplace(state_edge_ids, 0);
+	}
+
+	unsigned rank = 0;
+	for (auto& rec : ranks) {
+		rec.second = rank++;
+	}
+
+	for (auto& state_edge_ids : state_edges) {
+		frozen.add_state(ranks[state_edge_ids]);
+
+		for (auto edge_id : state_edge_ids) {
+			auto edge = edges[edge_id];
+			const auto& targets = edge->get_targets();
+			frozen.add_edge(edge->get_label(), targets.begin(), targets.end(), edge->get_marks().as_mark_t());
+		}
+	}
+
+	return frozen;
+}
+
 void SLAA::print_hoaf() {
 	bool sink_state_needed = false;
 	bool true_state_exists = false;
@@ -723,6 +966,10 @@ void SLAA::print_hoaf() {
 	std::cout << "name: \"SLAA for " << spot::unabbreviate(simp.simplify(phi), "WM") << "\"\n";
 	std::cout << "States: " << (sink_state_needed ? state_counter + 1 : state_counter) << '\n'; // + 1 is for sink state
 
+	// the dictionary may be shared with other automata, so the BDD
+	// variables are not the AP indices in general
+	auto ap_index = hoaf_ap_index(spot_aut);
+
 	auto bdd_dict = spot_aut->ap();
 	unsigned bdd_dict_size = bdd_dict.size();
 	std::cout << "AP: " << bdd_dict_size;
@@ -757,8 +1004,7 @@ void SLAA::print_hoaf() {
 			Edge* edge = edges[edge_id];
 
 			std::cout << "  [";
-			print_or = false;
-			bdd_allsat(edge->get_label(), allsatPrintHandler);
+			print_label_hoaf(edge->get_label(), ap_index);
 			std::cout << "] ";
 
 			bool target_printed = false;
@@ -918,8 +1164,190 @@ SLAA::SLAA(spot::formula f, spot::bdd_dict_ptr dict) {
 	phi = f;
 }
 
-NA::NA(std::vector<std::set<unsigned>>* sets) {
-	spot_id_to_slaa_set = sets;
+NA::NA(std::vector<std::set<unsigned>>* sets) : spot_id_to_slaa_set(sets) {
+}
+
+bool na_edge::operator==(const na_edge& other) const {
+	return dst == other.dst && label == other.label && marks == other.marks;
+}
+
+unsigned NA::get_state_id(unsigned name) {
+	unsigned size = states.size();
+	auto inserted = state_index.emplace(name, size);
+	if (!inserted.second) {
+		return inserted.first->second;
+	}
+
+	states.push_back(name);
+	state_edges.emplace_back();
+
+	// the merged initial state has no configuration, but no edge leads to it
+	if (name < spot_id_to_slaa_set->size()) {
+		const auto& config = (*spot_id_to_slaa_set)[name];
+		state_signature.push_back(states_signature(config.begin(), config.end()));
+	} else {
+		state_signature.push_back(0);
+	}
+
+	return size;
+}
+
+unsigned NA::state_name(unsigned state_id) const {
+	return states[state_id];
+}
+
+unsigned NA::states_count() const {
+	return states.size();
+}
+
+const std::vector<na_edge>& NA::get_state_edges(unsigned state_id) const {
+	assert(state_edges.size() > state_id);
+	return state_edges[state_id];
+}
+
+void NA::remember_inf_mark(const mark_set& marks) {
+	inf_marks.insert(marks);
+}
+
+bool NA::dominates(const na_edge& e1, const na_edge& e2) const {
+	// t1 kills t2 if O1 ⊆ O2 & a2 => a1
+	// the cheap tests go first: each not-Inf mark in J1 has to be in J2,
+	// each Inf mark in J2 has to be in J1 and the signature of O1
+	// has to be a subset of that of O2
+	if (!(e1.marks - inf_marks).subset_of(e2.marks) || !(e2.marks & inf_marks).subset_of(e1.marks)) {
+		return false;
+	}
+
+	if ((state_signature[e1.dst] & ~state_signature[e2.dst]) != 0) {
+		return false;
+	}
+
+	const auto& o1 = (*spot_id_to_slaa_set)[state_name(e1.dst)];
+	const auto& o2 = (*spot_id_to_slaa_set)[state_name(e2.dst)];
+
+	return std::includes(o2.begin(), o2.end(), o1.begin(), o1.end())
+		&& (e2.label & bdd_not(e1.label)) == bdd_false();
+}
+
+void NA::add_edge(unsigned from, bdd label, unsigned dst, mark_set marks) {
+	if (label == bddfalse) {
+		return;
+	}
+
+	na_edge e_this = { label, dst, marks };
+	auto& edges = state_edges[from];
+
+	// remove the edges dominated by the new edge
+	edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const na_edge& e_other) {
+		return dominates(e_this, e_other);
+	}), edges.end());
+
+	// do not add the new edge if some other edge dominates it
+	for (auto& e_other : edges) {
+		if (dominates(e_other, e_this)) {
+			return;
+		}
+	}
+
+	edges.push_back(e_this);
+}
+
+bool NA::dominates(bdd label1, target_range config1, const mark_set& marks1, bdd label2, target_range config2, const mark_set& marks2) const {
+	if (!(marks1 - inf_marks).subset_of(marks2) || !(marks2 & inf_marks).subset_of(marks1)) {
+		return false;
+	}
+
+	if ((states_signature(config1.begin(), config1.end()) & ~states_signature(config2.begin(), config2.end())) != 0) {
+		return false;
+	}
+
+	return std::includes(config2.begin(), config2.end(), config1.begin(), config1.end())
+		&& (label2 & bdd_not(label1)) == bdd_false();
+}
+
+bool NA::is_dominated(unsigned from, bdd label, target_range config, const mark_set& marks) const {
+	auto signature = states_signature(config.begin(), config.end());
+
+	for (auto& e_other : state_edges[from]) {
+		// the same tests as in dominates
+		if (!(e_other.marks - inf_marks).subset_of(marks) || !(marks & inf_marks).subset_of(e_other.marks)) {
+			continue;
+		}
+
+		if ((state_signature[e_other.dst] & ~signature) != 0) {
+			continue;
+		}
+
+		const auto& o_other = (*spot_id_to_slaa_set)[state_name(e_other.dst)];
+		if (std::includes(config.begin(), config.end(), o_other.begin(), o_other.end())
+			&& (label & bdd_not(e_other.label)) == bdd_false()
+		) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void NA::remove_edge(unsigned state_id, const na_edge& edge) {
+	auto& edges = state_edges[state_id];
+	auto it = std::find(edges.begin(), edges.end(), edge);
+	if (it != edges.end()) {
+		edges.erase(it);
+	}
+}
+
+void NA::remove_unreachable_states() {
+	std::vector<unsigned> conversion_table(states.size(), -1U);
+	std::queue<unsigned> bfs_queue;
+	unsigned reachable_state_ct = 0;
+
+	bfs_queue.push(init_state);
+	conversion_table[init_state] = reachable_state_ct++;
+	init_state = 0;
+
+	std::vector<unsigned> new_state_table;
+	std::vector<std::vector<na_edge>> new_state_edges_table;
+	std::vector<uint64_t> new_state_signature;
+
+	while (!bfs_queue.empty()) {
+		unsigned state_id = bfs_queue.front();
+		bfs_queue.pop();
+
+		// the states get the new IDs in the order they are queued
+		new_state_table.push_back(states[state_id]);
+		new_state_edges_table.push_back(std::move(state_edges[state_id]));
+		new_state_signature.push_back(state_signature[state_id]);
+
+		for (auto& edge : new_state_edges_table.back()) {
+			if (conversion_table[edge.dst] == -1U) {
+				// we didn't explore this state yet
+				// we'll assign a new ID and add it to BFS queue
+				conversion_table[edge.dst] = reachable_state_ct++;
+				bfs_queue.push(edge.dst);
+			}
+
+			// we replace target IDs with converted ones
+			edge.dst = conversion_table[edge.dst];
+		}
+	}
+
+	states = std::move(new_state_table);
+	state_edges = std::move(new_state_edges_table);
+	state_signature = std::move(new_state_signature);
+
+	state_index.clear();
+	for (unsigned state_id = 0; state_id < states.size(); ++state_id) {
+		state_index.emplace(states[state_id], state_id);
+	}
+}
+
+unsigned NA::get_init_state() const {
+	return init_state;
+}
+
+void NA::set_init_state(unsigned s) {
+	init_state = s;
 }
 
 // inspired by spot's twa_graph::merge_edges
@@ -930,76 +1358,51 @@ NA::NA(std::vector<std::set<unsigned>>* sets) {
 // the resulting label is disjunction of labels
 // and mark set is union of mark sets
 void NA::merge_edges() {
-	// set of edges IDs that are removed and we should ignore them
-	std::set<unsigned> removed_edges;
-
-	for (unsigned state_id = 0, states_no = states_count(); state_id < states_no; ++state_id) {
-		auto state_edges = get_state_edges(state_id);
-		std::vector<unsigned> edges_list(state_edges.begin(), state_edges.end());
-
-		for (unsigned i = 0; i < edges_list.size(); ++i) {
-			auto e1_id = edges_list[i];
+	for (auto& edges : state_edges) {
+		// edges merged into some previous edge; they are removed at the end
+		std::vector<bool> removed(edges.size(), false);
 
-			if (removed_edges.count(e1_id) > 0) {
+		for (unsigned i = 0; i < edges.size(); ++i) {
+			if (removed[i]) {
 				// this is not valid anymore
 				continue;
 			}
 
-			auto e1 = get_edge(e1_id);
-
-			for (unsigned j = i + 1; j < edges_list.size(); ++j) {
-				auto e2_id = edges_list[j];
+			auto& e1 = edges[i];
 
-				if (removed_edges.count(e2_id) > 0) {
+			for (unsigned j = i + 1; j < edges.size(); ++j) {
+				if (removed[j]) {
 					// this is not valid anymore
 					continue;
 				}
 
-				auto e2 = get_edge(e2_id);
-
-				auto j1 = e1->get_marks();
-				auto j2 = e2->get_marks();
-
-				auto l1 = e1->get_label();
-				auto l2 = e2->get_label();
+				const auto& e2 = edges[j];
 
-				if (e1->get_targets() == e2->get_targets()) {
-					// target sets are equal
-					if (j1 == j2) {
+				if (e1.dst == e2.dst) {
+					// targets are equal
+					if (e1.marks == e2.marks) {
 						// acceptance labels too; join these edges
-						e1->set_label(e1->get_label() | e2->get_label());
-						removed_edges.insert(e2_id);
-						remove_edge(state_id, e2_id);
-					} else if (l1 == l2) {
+						e1.label |= e2.label;
+						removed[j] = true;
+					} else if (e1.label == e2.label) {
 						// are all marks from J1 and J2 Inf marks?
-						bool merge_fail = false;
-
-						for (auto mark : j1) {
-							if (inf_marks.count(mark) == 0) {
-								merge_fail = true;
-								break;
-							}
-						}
-						if (!merge_fail) {
-							for (auto mark : j2) {
-								if (inf_marks.count(mark) == 0) {
-									merge_fail = true;
-									break;
-								}
-							}
-						}
-
-						if (!merge_fail) {
+						if ((e1.marks | e2.marks).subset_of(inf_marks)) {
 							// join these edges
-							e1->add_mark(j2);
-							e1->set_label(l1 | l2);
-							removed_edges.insert(e2_id);
-							remove_edge(state_id, e2_id);
+							e1.marks.insert(e2.marks);
+							removed[j] = true;
 						}
 					}
 				}
 			}
 		}
+
+		unsigned kept = 0;
+		for (unsigned i = 0; i < edges.size(); ++i) {
+			if (!removed[i]) {
+				edges[kept++] = edges[i];
+			}
+		}
+		edges.resize(kept);
 	}
 }
 
@@ -1018,12 +1421,10 @@ void NA::merge_equivalent_states() {
 
 			if (st_equiv) {
 				// retarget each s2-transition to s1
-				for (unsigned state_id = 0; state_id < states_size; ++state_id) {
-					for (auto& edge_id : get_state_edges(state_id)) {
-						auto edge = get_edge(edge_id);
-
-						if (*(edge->get_targets().begin()) == s2) {
-							edge->replace_target_set(std::set<unsigned>({ s1 }));
+				for (auto& edges : state_edges) {
+					for (auto& edge : edges) {
+						if (edge.dst == s2) {
+							edge.dst = s1;
 						}
 					}
 				}
@@ -1038,8 +1439,8 @@ void NA::merge_equivalent_states() {
 }
 
 bool NA::states_equivalent(unsigned s1, unsigned s2, unsigned eq_level) {
-	auto s1_edges = get_state_edges(s1);
-	auto s2_edges = get_state_edges(s2);
+	const auto& s1_edges = state_edges[s1];
+	const auto& s2_edges = state_edges[s2];
 
 	// do the edges sets have equal size?
 	if (s1_edges.size() != s2_edges.size()) {
@@ -1047,33 +1448,31 @@ bool NA::states_equivalent(unsigned s1, unsigned s2, unsigned eq_level) {
 	}
 
 	// for each edge of s1 find the corresponding edge of s2
-	std::set<unsigned> used_edge_ids;
-
-	for (auto& e1_id : s1_edges) {
-		auto e1 = get_edge(e1_id);
+	std::vector<bool> used(s2_edges.size(), false);
 
+	for (auto& e1 : s1_edges) {
 		bool corresponding_edge_found = false;
-		for (auto& e2_id : s2_edges) {
-			if (used_edge_ids.count(e2_id) > 0) {
+		for (unsigned j = 0; j < s2_edges.size(); ++j) {
+			if (used[j]) {
 				continue;
 			}
 
-			auto e2 = get_edge(e2_id);
+			const auto& e2 = s2_edges[j];
 
 			// do the edges have equal transition label and acceptance label?
-			if (e1->get_label() != e2->get_label()) {
+			if (e1.label != e2.label) {
 				continue;
 			}
 
-			if (e1->get_marks() != e2->get_marks()) {
+			if (e1.marks != e2.marks) {
 				continue;
 			}
 
-			// t1 and t2 are the only targets of our edges
+			// e1.dst and e2.dst are the only targets of our edges
 			// we can simply test δ(s1) = δ(s2), or, if we opted for it,
 			// check if δ(s1)[s1/r] = δ(s2)[s2/r] for a fresh state r
-			auto t1 = *(e1->get_targets().begin());
-			auto t2 = *(e2->get_targets().begin());
+			auto t1 = e1.dst;
+			auto t2 = e2.dst;
 
 			// that is, for this test to fail, either targets are not equal,
 			// or at least one of {t1, t2} is not a loop
@@ -1082,7 +1481,7 @@ bool NA::states_equivalent(unsigned s1, unsigned s2, unsigned eq_level) {
 			}
 
 			// if we got here, e1 and e2 are equivalent
-			used_edge_ids.insert(e2_id);
+			used[j] = true;
 			corresponding_edge_found = true;
 			break;
 		}
@@ -1097,10 +1496,8 @@ bool NA::states_equivalent(unsigned s1, unsigned s2, unsigned eq_level) {
 }
 
 template<typename T> Automaton<T>::~Automaton() {
-	for (auto e : edges) {
-		delete e;
-	}
-	edges.clear();
+	// the edges are freed with edge_pool
+	live_edges -= edges.size();
 }
 
 Edge::Edge(bdd l) {
@@ -1119,49 +1516,58 @@ void Edge::add_target(unsigned state_id) {
 	targets.insert(state_id);
 }
 
-void Edge::add_target(std::set<unsigned> state_ids) {
-	targets.insert(state_ids.begin(), state_ids.end());
+void Edge::add_target(const target_set& state_ids) {
+	targets.insert(state_ids);
 }
 
 void Edge::remove_target(unsigned state_id) {
-	auto target_it = targets.find(state_id);
-	if (target_it != targets.end()) {
-		targets.erase(target_it);
-	}
+	targets.erase(state_id);
 }
 
-void Edge::replace_target_set(std::set<unsigned> state_ids) {
-	targets.clear();
-	add_target(state_ids);
+void Edge::replace_target_set(target_set state_ids) {
+	targets = std::move(state_ids);
 }
 
 void Edge::add_mark(unsigned ix) {
 	marks.insert(ix);
 }
 
-void Edge::add_mark(std::set<unsigned> ixs) {
-	marks.insert(ixs.begin(), ixs.end());
+void Edge::add_mark(const mark_set& ixs) {
+	marks.insert(ixs);
 }
 
 void Edge::remove_mark(unsigned ix) {
-	auto mark_it = marks.find(ix);
-	if (mark_it != marks.end()) {
-		marks.erase(mark_it);
-	}
+	marks.erase(ix);
 }
 
 void Edge::clear_marks() {
 	marks.clear();
 }
 
-std::set<unsigned> Edge::get_targets() const {
+const target_set& Edge::get_targets() const {
 	return targets;
 }
 
-std::set<unsigned> Edge::get_marks() const {
+const mark_set& Edge::get_marks() const {
 	return marks;
 }
 
+size_t Edge::hash() const {
+	size_t h = label.id();
+	for (auto state : targets) {
+		h ^= state + 0x9e3779b9 + (h << 6) + (h >> 2);
+	}
+	for (auto mark : marks) {
+		h ^= mark + 0x7f4a7c15 + (h << 6) + (h >> 2);
+	}
+
+	return h;
+}
+
+bool Edge::operator==(const Edge& other) const {
+	return label == other.label && targets == other.targets && marks == other.marks;
+}
+
 // returns domination level
 // if O1 = O2 & J1 = J2 then returns 1
 // else if O1 ⊆ O2 & J1 ⊆ J2 but at least one inclusion is proper then
@@ -1169,31 +1575,23 @@ std::set<unsigned> Edge::get_marks() const {
 //   else returns 2
 // else returns 0
 // where edge 1 is this edge and edge 2 is the other edge
-int Edge::dominates(Edge* other, std::set<acc_mark> inf_marks) const {
-	auto o1 = get_targets();
-	auto j1 = get_marks();
+int Edge::dominates(Edge* other, const mark_set& inf_marks) const {
+	const auto& o1 = targets;
+	const auto& j1 = marks;
 
-	auto o2 = other->get_targets();
-	auto j2 = other->get_marks();
+	const auto& o2 = other->targets;
+	const auto& j2 = other->marks;
 
 	// now check if O1 ⊆ O2 & J1 ⊆ J2
-	if (!std::includes(o2.begin(), o2.end(), o1.begin(), o1.end())) {
+	if (!o1.subset_of(o2)) {
 		return 0;
 	}
 
-		// each not-Inf mark in J1 has to be in J2
-		for (auto mark : j1) {
-			if (inf_marks.count(mark) == 0 && j2.count(mark) == 0) {
-				return 0;
-			}
-		}
-
-		// and each Inf mark in J2 has to be in J1
-		for (auto mark : j2) {
-			if (inf_marks.count(mark) > 0 && j1.count(mark) == 0) {
-				return 0;
-			}
-		}
+	// each not-Inf mark in J1 has to be in J2
+	// and each Inf mark in J2 has to be in J1
+	if (!(j1 - inf_marks).subset_of(j2) || !(j2 & inf_marks).subset_of(j1)) {
+		return 0;
+	}
 
 	// is some inclusion proper?
 	if (o1.size() == o2.size() && j1 == j2) {
@@ -1203,31 +1601,3 @@ int Edge::dominates(Edge* other, std::set<acc_mark> inf_marks) const {
 		return ((other->get_label() & bdd_not(get_label())) == bdd_false()) ? 3 : 2;
 	}
 }
-
-int Edge::dominates(Edge* other, std::set<unsigned> o1, std::set<unsigned> o2, std::set<acc_mark> inf_marks) const {
-	// t1 kills t2 if O1 ⊆ O2 & a2 => a1
-	auto j1 = get_marks();
-	auto j2 = other->get_marks();
-
-	if (std::includes(o2.begin(), o2.end(), o1.begin(), o1.end())
-		&& (other->get_label() & bdd_not(get_label())) == bdd_false()
-	) {
-		// each not-Inf mark in J1 has to be in J2
-		for (auto mark : j1) {
-			if (inf_marks.count(mark) == 0 && j2.count(mark) == 0) {
-				return 0;
-			}
-		}
-
-		// and each Inf mark in J2 has to be in J1
-		for (auto mark : j2) {
-			if (inf_marks.count(mark) > 0 && j1.count(mark) == 0) {
-				return 0;
-			}
-		}
-
-		return 3;
-	} else {
-		return 0;
-	}
-}
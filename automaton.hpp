@@ -20,9 +20,11 @@
 #ifndef AUTOMATON_H
 #define AUTOMATON_H
 #include <algorithm>
+#include <deque>
 #include <map>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <sstream>
 #include <spot/tl/print.hh>
 #include <queue>
@@ -38,16 +40,19 @@
 #include <spot/twaalgos/simulation.hh>
 #include <spot/twaalgos/sccfilter.hh>
 #include "utils.hpp"
+#include "deadline.hpp"
+#include "sets.hpp"
+#include "frozen.hpp"
 
 typedef unsigned acc_mark;
 
 class Edge {
 protected:
 	// target set of the edge
-	std::set<unsigned> targets;
+	target_set targets;
 
 	// the acceptance label
-	std::set<acc_mark> marks;
+	mark_set marks;
 
 	// the transition labels in BDD
 	bdd label;
@@ -56,17 +61,17 @@ public:
 
 	// adds a state or a set of states to the target set
 	void add_target(unsigned state_id);
-	void add_target(std::set<unsigned> state_ids);
+	void add_target(const target_set& state_ids);
 
 	// removes a state from the target set
 	void remove_target(unsigned state_id);
 
 	// replaces the target set with given set
-	void replace_target_set(std::set<unsigned> state_ids);
+	void replace_target_set(target_set state_ids);
 
 	// adds an acceptance mark or a set of them
 	void add_mark(unsigned ix);
-	void add_mark(std::set<unsigned> ixs);
+	void add_mark(const mark_set& ixs);
 
 	// removes an acceptance mark
 	void remove_mark(unsigned ix);
@@ -75,10 +80,10 @@ public:
 	void clear_marks();
 
 	// returns the target set
-	std::set<unsigned> get_targets() const;
+	const target_set& get_targets() const;
 
 	// returns the acceptance label
-	std::set<unsigned> get_marks() const;
+	const mark_set& get_marks() const;
 
 	// returns the transition label
 	bdd get_label() const;
@@ -86,8 +91,13 @@ public:
 	// sets the transition label
 	void set_label(bdd l);
 
-	int dominates(Edge* other, std::set<unsigned> o1, std::set<unsigned> o2, std::set<acc_mark> inf_marks) const;
-	int dominates(Edge* other, std::set<acc_mark> inf_marks) const;
+	int dominates(Edge* other, const mark_set& inf_marks) const;
+
+	// returns a hash of the label, targets and marks
+	size_t hash() const;
+
+	// returns true if the edges have the same label, targets and marks
+	bool operator==(const Edge& other) const;
 };
 
 template<typename T> class Automaton {
@@ -95,16 +105,38 @@ protected:
 	// vector of names of states
 	std::vector<T> states;
 
-	// vector of edges
+	// index of `states': maps a name to its ID
+	std::unordered_map<T, unsigned> state_index;
+
+	// the edges are allocated in edge_pool (a deque keeps them in place),
+	// edges maps an edge ID to its address
+	std::deque<Edge> edge_pool;
 	std::vector<Edge*> edges;
 
 	// state_edges maps a set of edges to each state
 	std::vector<std::set<unsigned>> state_edges;
 
-	std::vector<std::set<unsigned>>* spot_id_to_slaa_set = nullptr; // this has to be nullptr for SLAA
+	// maps the hash of an edge used by some state to its ID; the SLAA shares
+	// edges equal in content among the states, see add_edge and unshare_edges
+	std::unordered_multimap<size_t, unsigned> edge_index;
+
+	// returns the ID of an indexed edge equal to the given one or -1U
+	unsigned find_equal_edge(unsigned edge_id, size_t h) const;
+
+	// gives every state its own copy of each edge it shares with another state
+	// and empties the edge index; called before the edges are changed in place
+	void unshare_edges();
+
+	// adds the created edge to the source, removing the edges it dominates and
+	// relabeling or dropping it if it is dominated; the copies of the partially
+	// dominated edges are processed in the same way until nothing changes
+	void add_dominating_edge(unsigned from, unsigned edge_id);
+
+	// adds the created edge (or an equal indexed one) to the source
+	void insert_edge(unsigned from, unsigned edge_id);
 
 	// a set of Inf-marks used in the automaton
-	std::set<acc_mark> inf_marks;
+	mark_set inf_marks;
 
 	// the set of initial configurations
 	std::set<std::set<unsigned>> init_sets;
@@ -125,14 +157,18 @@ public:
 	// creates an edge and returns its ID (index in the `edges' set)
 	unsigned create_edge(bdd label);
 
+	// frees the edges not used by any state; the other edges are renumbered
+	// preserving their order
+	void compact_edges();
+
 	// creates an edge with given source state, labels and target set
-	void add_edge(unsigned from, bdd label, std::set<unsigned> to, std::set<acc_mark> marks = std::set<acc_mark>());
+	void add_edge(unsigned from, bdd label, target_set to, mark_set marks = mark_set());
 
 	// copies the given edge to the source `from'
 	void add_edge(unsigned from, unsigned edge_id);
 
 	// copies the given edges to the source `from'
-	void add_edge(unsigned from, std::set<unsigned> edge_ids);
+	void add_edge(unsigned from, const std::set<unsigned>& edge_ids);
 
 	// removes the given edge from the source
 	void remove_edge(unsigned state_id, unsigned edge_id);
@@ -141,28 +177,49 @@ public:
 	Edge* get_edge(unsigned edge_id) const;
 
 	// returns state_edges[state_id]
-	std::set<unsigned> get_state_edges(unsigned state_id) const;
+	// the reference is invalidated when a state is added
+	const std::set<unsigned>& get_state_edges(unsigned state_id) const;
 
 	// returns the registered Inf-marks
-	std::set<acc_mark> get_inf_marks() const;
+	const mark_set& get_inf_marks() const;
+
+	// replaces the edges of all states by the indexed edges equal in content,
+	// so that states with equal edges have equal sets of edge IDs
+	void share_edges();
 
 	// registers the marks in the set `inf_marks'
 	void remember_inf_mark(acc_mark mark);
-	void remember_inf_mark(std::set<acc_mark> marks);
+	void remember_inf_mark(const mark_set& marks);
 
 	// removes states unreachable from the initial states
+	// and frees the edges that are not used anymore
 	void remove_unreachable_states();
 
 	// returns an edge ID that is a (mark-preserving or mark-discarding) product of given edges
 	unsigned edge_product(unsigned e1, unsigned e2, bool preserve_mark_sets);
 
-	// for the family of sets { M_1, ..., M_n } of edges,
-	// returns set of products of each n edges from distinct M_i
-	std::set<unsigned> product(std::set<std::set<unsigned>> edges_sets, bool preserve_mark_sets);
-
 	~Automaton();
 };
 
+// returns the maximal number of edges allocated at once by all automata
+// since the last call of reset_edges_peak
+unsigned long edges_peak();
+void reset_edges_peak();
+
+// returns the number of edges added with the domination check (-d)
+// and the number of domination tests needed for them
+// since the last call of reset_domination_stats
+unsigned long domination_insertions();
+unsigned long domination_checks();
+void reset_domination_stats();
+
+// returns the map { BDD variable => index of the AP in the HOA output of aut }
+std::map<int, unsigned> hoaf_ap_index(const spot::const_twa_ptr& aut);
+
+// prints the label to STDOUT as a HOA label (a disjunction of its
+// satisfying assignments) with the AP indices given by ap_index
+void print_label_hoaf(bdd label, const std::map<int, unsigned>& ap_index);
+
 class SLAA : public Automaton<spot::formula> {
 protected:
 	spot::formula phi;
@@ -194,14 +251,25 @@ public:
 	// acceptance formula of each Until state
 	std::map<spot::formula, acc_phi> acc;
 
+	// the maximal size of DNF of right operand of U-subformulae
+	// used for sharing the disjunction marks with -G0
+	unsigned max_u_disj_size = 1;
+
 	// creates an edge with given source state, labels and target set
-	void add_edge(unsigned from, bdd label, std::set<unsigned> to, std::set<acc_mark> marks = std::set<acc_mark>());
+	void add_edge(unsigned from, bdd label, target_set to, mark_set marks = mark_set());
 
 	// copies the given edge to the source `from'
 	void add_edge(unsigned from, unsigned edge_id);
 
 	// copies the given edges to the source `from'
-	void add_edge(unsigned from, std::set<unsigned> edge_ids);
+	void add_edge(unsigned from, const std::set<unsigned>& edge_ids);
+
+	// for the family of sets { M_1, ..., M_n } of edges, adds to the source
+	// the products of each n edges from distinct M_i with a satisfiable label
+	// only the products are allocated, the partial ones are pruned as soon
+	// as their label is false; they are added in the order of the n-tuples
+	// of edge IDs; the sets may not be the edges of the source itself
+	void add_product(unsigned from, const std::set<std::set<unsigned>>& edges_sets, bool preserve_mark_sets);
 
 	// sets the Spot acceptance condition from acc
 	void build_acc();
@@ -210,10 +278,10 @@ public:
 	void remove_unnecessary_marks();
 
 	// returns a set of initial configurations
-	std::set<std::set<unsigned>> get_init_sets() const;
+	const std::set<std::set<unsigned>>& get_init_sets() const;
 
 	// adds an initial configuration
-	void add_init_set(std::set<unsigned> init_set);
+	void add_init_set(const std::set<unsigned>& init_set);
 
 	// converts the automaton to single-owner
 	// the output argument tgba_mark_owners contains pairs of mark j and its owner q
@@ -228,6 +296,9 @@ public:
 	// register a pair of dominating and dominated states
 	void register_dom_states(unsigned strong, unsigned weak, unsigned option_level);
 
+	// returns a read-only snapshot of the automaton for the subset construction
+	frozen_slaa freeze() const;
+
 	// prints the automaton in HOA format
 	void print_hoaf();
 
@@ -237,8 +308,78 @@ public:
 	SLAA(spot::formula f, spot::bdd_dict_ptr dict = nullptr);
 };
 
-class NA : public Automaton<unsigned> {
+// an edge of the NA; unlike the SLAA edges, it has exactly one target
+struct na_edge {
+	bdd label;
+	unsigned dst;
+	mark_set marks;
+
+	bool operator==(const na_edge& other) const;
+};
+
+class NA {
+protected:
+	// vector of names of states (their IDs in the Spot automaton)
+	std::vector<unsigned> states;
+
+	// index of `states': maps a name to its ID
+	std::unordered_map<unsigned, unsigned> state_index;
+
+	// the edges leaving each state
+	std::vector<std::vector<na_edge>> state_edges;
+
+	// maps the name of a state to its configuration (set of SLAA states)
+	std::vector<std::set<unsigned>>* spot_id_to_slaa_set;
+
+	// the signatures (see states_signature) of the configurations of states;
+	// they reject most pairs of edges in dominates before the configurations are compared
+	std::vector<uint64_t> state_signature;
+
+	// a set of Inf-marks used in the automaton
+	mark_set inf_marks;
+
+	unsigned init_state = 0;
+
+	// returns true if e1 makes e2 redundant, i.e. the configuration
+	// of the target of e1 is a subset of that of e2, a2 => a1 and
+	// e1 has no more Fin-marks and no less Inf-marks than e2
+	bool dominates(const na_edge& e1, const na_edge& e2) const;
+
 public:
+	// returns a state ID by its name, possibly creating a new one
+	unsigned get_state_id(unsigned name);
+
+	// returns a name of the state with the given ID
+	unsigned state_name(unsigned state_id) const;
+
+	// returns the number of states
+	unsigned states_count() const;
+
+	// adds an edge unless some edge of the source dominates it;
+	// the edges of the source dominated by the new one are removed
+	void add_edge(unsigned from, bdd label, unsigned dst, mark_set marks = mark_set());
+
+	// returns true if some edge of the source dominates the edge with the given
+	// label, marks and the target with the given configuration; such an edge
+	// would not be added and it cannot make any edge of the source redundant
+	bool is_dominated(unsigned from, bdd label, target_range config, const mark_set& marks) const;
+
+	// the domination test of dominates for edges whose targets are not states yet
+	bool dominates(bdd label1, target_range config1, const mark_set& marks1, bdd label2, target_range config2, const mark_set& marks2) const;
+
+	// removes the edge equal to the given one from the source, if any
+	void remove_edge(unsigned state_id, const na_edge& edge);
+
+	// returns the edges of the state
+	// the reference is invalidated when a state is added
+	const std::vector<na_edge>& get_state_edges(unsigned state_id) const;
+
+	// registers the marks in the set `inf_marks'
+	void remember_inf_mark(const mark_set& marks);
+
+	// removes states unreachable from the initial state
+	void remove_unreachable_states();
+
 	// merges edges with the same source and target
 	void merge_edges();
 
@@ -249,8 +390,6 @@ public:
 	// with the equivalence test from LTL2BA or LTL3BA
 	bool states_equivalent(unsigned s1, unsigned s2, unsigned eq_level);
 
-	// setter and getter of the init states are wrappers
-	// over the structure of initial configurations
 	// sets the init state
 	void set_init_state(unsigned s);
 
@@ -0,0 +1,344 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "batch.hpp"
+
+int translate_and_print(spot::formula f, std::map<std::string, std::string>& args, spot::bdd_dict_ptr dict) {
+	unsigned int print_phase = std::stoi(args["p"]);
+
+	if (args["o"] == "stream") {
+		try {
+			stream_formula(f, dict);
+		} catch (deadline_exceeded& e) {
+			std::cerr << "The deadline was exceeded in " << e.get_stage() << ", the printed automaton is aborted.\n";
+			return 3;
+		} catch (std::runtime_error& e) {
+			std::string what(e.what());
+
+			if (what.find("Too many acceptance sets used.") == 0) {
+				std::cerr << "LTL3TELA is unable to set more than 32 acceptance marks.\n";
+				return 32;
+			} else {
+				std::cerr << what << std::endl;
+				return 3;
+			}
+		}
+
+		std::cout << '\n';
+		return 0;
+	}
+
+	spot::twa_graph_ptr nwa = nullptr;
+	SLAA* slaa = nullptr;
+	std::string stats("");
+
+	try {
+		std::tie(nwa, slaa, stats) = translate_formula(f, dict, print_phase & 1, print_phase == 1);
+	} catch (std::runtime_error& e) {
+		std::string what(e.what());
+
+		if (what.find("Too many acceptance sets used.") == 0) {
+			std::cerr << "LTL3TELA is unable to set more than 32 acceptance marks.\n";
+			return 32;
+		} else {
+			std::cerr << what << std::endl;
+			return 3;
+		}
+	}
+
+	if (slaa) {
+		if (args["o"] == "dot") {
+			slaa->print_dot();
+		} else {
+			slaa->print_hoaf();
+		}
+
+		delete slaa;
+	}
+
+	if (nwa) {
+		if (args["o"] == "dot") {
+			spot::print_dot(std::cout, nwa);
+		} else {
+			spot::print_hoa(std::cout, nwa);
+			std::cout << '\n';
+		}
+	}
+
+	if (!deadline_stage().empty()) {
+		std::cerr << "The deadline was exceeded in " << deadline_stage() << ", the best automaton found so far is printed.\n";
+	}
+
+	if (o_debug & 1) {
+		std::cerr << stats;
+	}
+
+	// the internal counters are kept apart from the -x1 output parsed by the experiments
+	if (o_debug & 4) {
+		std::cerr << "peak edges: " << edges_peak() << '\n';
+		std::cerr << "domination checks: " << domination_checks() << " for " << domination_insertions() << " edges\n";
+		std::cerr << "product cache: " << product_hits() << " hits, " << product_misses() << " misses\n";
+	}
+
+	return 0;
+}
+
+int run_captured(std::function<int()> body, std::string& out, std::string& err) {
+	std::ostringstream out_stream;
+	std::ostringstream err_stream;
+
+	auto cout_buf = std::cout.rdbuf(out_stream.rdbuf());
+	auto cerr_buf = std::cerr.rdbuf(err_stream.rdbuf());
+
+	int ret;
+	try {
+		ret = body();
+	} catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		ret = 3;
+	} catch (const char* e) {
+		std::cerr << e << std::endl;
+		ret = 3;
+	}
+
+	std::cout.rdbuf(cout_buf);
+	std::cerr.rdbuf(cerr_buf);
+
+	out = out_stream.str();
+	err = err_stream.str();
+
+	return ret;
+}
+
+// translates one line of the formula list, reporting errors with the line number
+static int translate_line(const std::string& filename, unsigned line_no, const std::string& line, std::map<std::string, std::string>& args, spot::bdd_dict_ptr dict) {
+	spot::formula f;
+	try {
+		f = spot::parse_formula(line);
+	} catch (spot::parse_error& e) {
+		std::cerr << filename << ":" << line_no << ": The input formula is invalid.\n" << e.what();
+		return 1;
+	}
+
+	int ret = translate_and_print(f, args, dict);
+	if (ret != 0) {
+		std::cerr << filename << ":" << line_no << ": The translation failed.\n";
+	}
+
+	return ret;
+}
+
+// a worker receives pairs (line number, formula) and answers
+// with the exit code, the captured STDOUT and the captured STDERR
+static void run_worker(int in_fd, int out_fd, const std::string& filename, std::map<std::string, std::string>& args, spot::bdd_dict_ptr dict) {
+	std::string line_no;
+	std::string line;
+
+	while (read_message(in_fd, line_no) && read_message(in_fd, line)) {
+		std::string out;
+		std::string err;
+
+		int ret = run_captured([&]() {
+			return translate_line(filename, std::stoul(line_no), line, args, dict);
+		}, out, err);
+
+		if (!write_message(out_fd, std::to_string(ret))
+			|| !write_message(out_fd, out)
+			|| !write_message(out_fd, err)) {
+			break;
+		}
+	}
+}
+
+typedef struct {
+	int ret;
+	std::string out;
+	std::string err;
+} worker_result;
+
+static int translate_formula_list_parallel(std::istream& in, const std::string& filename, unsigned jobs, std::map<std::string, std::string>& args, spot::bdd_dict_ptr dict) {
+	// a dead worker must not kill us when we write to it
+	signal(SIGPIPE, SIG_IGN);
+
+	std::vector<child_process> workers;
+	// the job (index of formula) each worker is busy with, -1U if idle
+	std::vector<unsigned> busy_with;
+	// line numbers of the formulae, by index
+	std::vector<unsigned> line_numbers;
+
+	auto spawn_worker = [&]() {
+		std::vector<int> fds;
+		for (auto& w : workers) {
+			fds.push_back(w.to_child);
+			fds.push_back(w.from_child);
+		}
+		return fork_child([&](int in_fd, int out_fd) {
+			run_worker(in_fd, out_fd, filename, args, dict);
+		}, fds);
+	};
+
+	for (unsigned i = 0; i < jobs; ++i) {
+		workers.push_back(spawn_worker());
+		busy_with.push_back(-1U);
+	}
+
+	int result = 0;
+	unsigned line_no = 0;
+	bool input_done = false;
+	unsigned next_to_print = 0;
+	std::map<unsigned, worker_result> finished;
+
+	// sends the next formula to the worker, returns false if there is none
+	auto dispatch = [&](unsigned w) {
+		std::string line;
+		while (!input_done) {
+			if (!std::getline(in, line)) {
+				input_done = true;
+				break;
+			}
+			++line_no;
+
+			// skip empty lines
+			if (line.find_first_not_of(" \t\r") == std::string::npos) {
+				continue;
+			}
+
+			busy_with[w] = line_numbers.size();
+			line_numbers.push_back(line_no);
+			write_message(workers[w].to_child, std::to_string(line_no));
+			write_message(workers[w].to_child, line);
+			return true;
+		}
+		return false;
+	};
+
+	unsigned running = 0;
+	for (unsigned w = 0; w < jobs; ++w) {
+		if (dispatch(w)) {
+			++running;
+		}
+	}
+
+	while (running > 0) {
+		// poll, unlike select, works with descriptors above FD_SETSIZE (large -j)
+		std::vector<pollfd> ready(jobs);
+		for (unsigned w = 0; w < jobs; ++w) {
+			// negative descriptors of the idle workers are ignored
+			ready[w].fd = busy_with[w] != -1U ? workers[w].from_child : -1;
+			ready[w].events = POLLIN;
+			ready[w].revents = 0;
+		}
+
+		if (poll(ready.data(), ready.size(), -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::runtime_error("Waiting for the workers failed.");
+		}
+
+		for (unsigned w = 0; w < jobs; ++w) {
+			// a dead worker is reported by POLLHUP, the read below then fails
+			if (busy_with[w] == -1U || (ready[w].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+				continue;
+			}
+
+			unsigned index = busy_with[w];
+			busy_with[w] = -1U;
+			--running;
+
+			std::string ret;
+			worker_result r;
+			if (read_message(workers[w].from_child, ret)
+				&& read_message(workers[w].from_child, r.out)
+				&& read_message(workers[w].from_child, r.err)) {
+				r.ret = std::stoi(ret);
+			} else {
+				// the worker died (e.g. on an unhandled exception), replace it
+				finish_child(workers[w]);
+				workers[w] = spawn_worker();
+
+				r.ret = 3;
+				r.err = filename + ":" + std::to_string(line_numbers[index]) + ": The translation failed.\n";
+			}
+			finished[index] = r;
+
+			if (dispatch(w)) {
+				++running;
+			}
+		}
+
+		// print the finished translations in the input order
+		while (finished.count(next_to_print) > 0) {
+			auto& r = finished[next_to_print];
+			std::cout << r.out;
+			std::cout.flush();
+			std::cerr << r.err;
+			if (r.ret != 0) {
+				result = r.ret;
+			}
+			finished.erase(next_to_print);
+			++next_to_print;
+		}
+	}
+
+	for (auto& w : workers) {
+		finish_child(w);
+	}
+
+	return result;
+}
+
+int translate_formula_list(std::string filename, std::map<std::string, std::string>& args, spot::bdd_dict_ptr dict) {
+	std::ifstream file;
+	if (filename != "-") {
+		file.open(filename);
+		if (!file) {
+			std::cerr << "Cannot open " << filename << ".\n";
+			return 2;
+		}
+	}
+	std::istream& in = filename == "-" ? std::cin : file;
+
+	unsigned jobs = args.count("j") > 0 ? std::stoul(args["j"]) : 1;
+	if (jobs > 1) {
+		return translate_formula_list_parallel(in, filename, jobs, args, dict);
+	}
+
+	int result = 0;
+	unsigned line_no = 0;
+	std::string line;
+
+	while (std::getline(in, line)) {
+		++line_no;
+
+		// skip empty lines
+		if (line.find_first_not_of(" \t\r") == std::string::npos) {
+			continue;
+		}
+
+		int ret = translate_line(filename, line_no, line, args, dict);
+		if (ret != 0) {
+			result = ret;
+		}
+		// flush each automaton so that consumers may read them as they come
+		std::cout.flush();
+	}
+
+	return result;
+}
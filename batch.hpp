@@ -0,0 +1,55 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BATCH_H
+#define BATCH_H
+#include <cerrno>
+#include <csignal>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <poll.h>
+#include <spot/twaalgos/dot.hh>
+#include <spot/twaalgos/hoa.hh>
+#include "utils.hpp"
+#include "automaton.hpp"
+#include "nondeterministic.hpp"
+#include "parallel.hpp"
+#include "stream.hpp"
+#include "translator.hpp"
+
+// translates the formula with the options set by set_options
+// and prints the result to STDOUT; returns the exit code
+int translate_and_print(spot::formula f, std::map<std::string, std::string>& args, spot::bdd_dict_ptr dict);
+
+// runs body with STDOUT and STDERR redirected to the given strings
+// returns the value of body, or 3 if it threw an exception
+int run_captured(std::function<int()> body, std::string& out, std::string& err);
+
+// translates each formula of the given file (one formula per line, "-" for STDIN)
+// the BDD package and the dictionary are shared by all translations
+// invalid formulae are reported to STDERR and do not stop the run
+// with -j N, the formulae are translated by N worker processes
+// and the results are printed in the input order
+int translate_formula_list(std::string filename, std::map<std::string, std::string>& args, spot::bdd_dict_ptr dict);
+
+#endif
@@ -0,0 +1,205 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+#include <spot/misc/version.hh>
+#include <spot/parseaut/public.hh>
+#include <spot/twaalgos/hoa.hh>
+#include "cache.hpp"
+
+namespace fs = std::filesystem;
+
+// the header of every cache entry, change when the format changes
+static const std::string cache_magic("ltl3tela-cache 1\n");
+
+// FNV-1a, stable across compilers unlike std::hash
+static uint64_t cache_hash(const std::string& s) {
+	uint64_t h = 14695981039346656037ULL;
+	for (unsigned char c : s) {
+		h ^= c;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+static fs::path cache_path(const std::string& key) {
+	std::ostringstream name;
+	name << std::hex << cache_hash(key) << ".hoa";
+	return fs::path(o_cache_dir) / name.str();
+}
+
+std::string cache_key(spot::formula f) {
+	std::ostringstream key;
+
+	key << "ltl3tela " << LTL3TELA_VERSION << " spot " << spot::version() << '\n'
+		// the cache options and -P do not change the result
+		<< " -A" << o_antichain << " -b" << o_try_ltl2tgba_spotela << " -B" << o_bound_slack << " -c" << o_slaa_trans_red << " -i" << o_single_init_state
+		<< " -d" << o_slaa_determ << " -e" << o_eq_level << " -l" << o_ltl_split
+		<< " -n" << o_try_negation << " -s" << o_simplify_formula << " -t" << o_ac_filter_fin
+		<< " -x" << (o_debug & 3) << " -D" << o_deterministic << " -F" << o_u_merge_level
+		<< " -G" << o_g_merge_level << " -O" << o_disj_merging << " -X" << o_x_single_succ << '\n'
+		// str_psl would depend on the order in which the process created the formulae
+		<< structural_order().str(f) << '\n';
+
+	return key.str();
+}
+
+// reads a string stored as "length\ncontent"
+static bool read_chunk(std::istream& in, std::string& s) {
+	size_t len;
+	if (!(in >> len) || in.get() != '\n') {
+		return false;
+	}
+
+	s.resize(len);
+	return len == 0 || in.read(&s[0], len);
+}
+
+std::pair<spot::twa_graph_ptr, std::string> cache_lookup(const std::string& key, spot::bdd_dict_ptr dict) {
+	auto path = cache_path(key);
+	std::ifstream in(path, std::ios::binary);
+	std::string magic(cache_magic.size(), '\0');
+	std::string stored_key, stats;
+
+	// the entry may be missing, evicted meanwhile, or belong to a different key with the same hash
+	if (!in || !in.read(&magic[0], magic.size()) || magic != cache_magic
+		|| !read_chunk(in, stored_key) || stored_key != key || !read_chunk(in, stats)) {
+		return std::make_pair(nullptr, "");
+	}
+
+	std::string hoa((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	spot::automaton_stream_parser parser(hoa.c_str(), path.string());
+	auto parsed = parser.parse(dict);
+	if (!parsed->aut || !parsed->errors.empty()) {
+		return std::make_pair(nullptr, "");
+	}
+
+	// the modification time orders the entries for eviction
+	std::error_code ec;
+	fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+	return std::make_pair(parsed->aut, stats);
+}
+
+// removes the least recently used entries until the cache fits into o_cache_size MiB
+static void cache_evict() {
+	std::error_code ec;
+	std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+	uintmax_t total = 0;
+
+	// a temporary file older than this was left by a writer that crashed
+	// before renaming it; a younger one may be still being written
+	const auto tmp_grace = std::chrono::minutes(10);
+	auto now = fs::file_time_type::clock::now();
+
+	// the iterator is advanced with an error code, as another process
+	// may remove an entry concurrently
+	fs::directory_iterator it(o_cache_dir, ec);
+	for (; !ec && it != fs::directory_iterator(); it.increment(ec)) {
+		const auto& entry_path = it->path();
+		bool is_tmp = entry_path.filename().string().find(".hoa.tmp") != std::string::npos;
+		if (entry_path.extension() != ".hoa" && !is_tmp) {
+			continue;
+		}
+
+		std::error_code entry_ec;
+		auto size = fs::file_size(entry_path, entry_ec);
+		auto time = fs::last_write_time(entry_path, entry_ec);
+		if (entry_ec) {
+			// removed by another process
+			continue;
+		}
+
+		if (is_tmp) {
+			if (now - time > tmp_grace) {
+				fs::remove(entry_path, entry_ec);
+			} else {
+				total += size;
+			}
+			continue;
+		}
+
+		total += size;
+		entries.emplace_back(time, entry_path);
+	}
+
+	uintmax_t limit = uintmax_t(o_cache_size) << 20;
+	if (total <= limit) {
+		return;
+	}
+
+	std::sort(entries.begin(), entries.end());
+
+	for (auto& e : entries) {
+		if (total <= limit) {
+			break;
+		}
+
+		auto size = fs::file_size(e.second, ec);
+		if (!ec && fs::remove(e.second, ec)) {
+			total -= size;
+		}
+	}
+}
+
+void cache_store(const std::string& key, spot::twa_graph_ptr aut, const std::string& stats) {
+	std::error_code ec;
+	fs::create_directories(o_cache_dir, ec);
+
+	auto path = cache_path(key);
+	// write into a private file and rename it, so that concurrent
+	// processes never see a partially written entry
+	auto tmp_path = path;
+	tmp_path += ".tmp" + std::to_string(getpid());
+
+	{
+		std::ofstream out(tmp_path, std::ios::binary);
+		if (!out) {
+			return;
+		}
+
+		out << cache_magic << key.size() << '\n' << key << stats.size() << '\n' << stats;
+		spot::print_hoa(out, aut);
+		out << '\n';
+
+		if (!out) {
+			out.close();
+			fs::remove(tmp_path, ec);
+			return;
+		}
+	}
+
+	fs::rename(tmp_path, path, ec);
+	if (ec) {
+		fs::remove(tmp_path, ec);
+		return;
+	}
+
+	cache_evict();
+}
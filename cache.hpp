@@ -0,0 +1,44 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef CACHE_H
+#define CACHE_H
+#include <string>
+#include <utility>
+#include <spot/tl/formula.hh>
+#include <spot/twa/twagraph.hh>
+#include "utils.hpp"
+
+// the on-disk translation cache enabled by -C dir;
+// each entry is a file holding the key, the stats string and the HOA
+// of the automaton; the least recently used entries are removed
+// when the directory grows over o_cache_size MiB (-K)
+
+// returns the key of the translation of f (already simplified)
+// with the current o_* options, LTL3TELA and Spot versions
+std::string cache_key(spot::formula f);
+
+// returns the cached automaton and stats string or nullptr if there is no entry
+std::pair<spot::twa_graph_ptr, std::string> cache_lookup(const std::string& key, spot::bdd_dict_ptr dict);
+
+// stores the automaton and stats string, then evicts old entries
+void cache_store(const std::string& key, spot::twa_graph_ptr aut, const std::string& stats);
+
+#endif
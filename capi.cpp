@@ -0,0 +1,159 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <spot/twaalgos/dot.hh>
+#include <spot/twaalgos/hoa.hh>
+#include <spot/twaalgos/isdet.hh>
+#include "ltl3tela.h"
+#include "translator.hpp"
+
+// the dictionary shared by all calls; the BDD package is initialized with it
+static spot::bdd_dict_ptr capi_dict = nullptr;
+
+static char* copy_to_c(const std::string& s) {
+	char* r = static_cast<char*>(std::malloc(s.size() + 1));
+	std::memcpy(r, s.c_str(), s.size() + 1);
+	return r;
+}
+
+static int translate_to_string(const char* formula, const char* flags, int what, std::string& result) {
+	if (!capi_dict) {
+		// the host may use Spot (and thus BuDDy) itself, e.g. Python with spot imported
+		if (!bdd_isrunning()) {
+			bdd_init(1000, 1000);
+			// hide "garbage collection" messages from BuDDy
+			bdd_gbc_hook(nullptr);
+		}
+		capi_dict = spot::make_bdd_dict();
+	}
+
+	// build argv as if the flags were given on the command line
+	std::vector<std::string> tokens = { "ltl3tela" };
+	std::istringstream in(flags ? flags : "");
+	std::string token;
+	while (in >> token) {
+		tokens.push_back(token);
+	}
+
+	std::vector<char*> argv;
+	for (auto& t : tokens) {
+		argv.push_back(&t[0]);
+	}
+
+	auto args = parse_arguments(argv.size(), argv.data());
+	if (tokens.size() > 1 && args.empty()) {
+		result = "Invalid flags.\n";
+		return 1;
+	}
+	// -m prints its result and exits, which would stop the host process
+	if (args.count("f") > 0 || args.count("L") > 0 || args.count("S") > 0 || (args.count("p") > 0 && args["p"] != "2") || (args.count("m") > 0 && args["m"] != "0")) {
+		result = "Flags -f, -L, -S, -m and -p are not supported.\n";
+		return 1;
+	}
+	if (args.empty()) {
+		// no flags, fill in the defaults
+		char f_flag[] = "-f";
+		char f_value[] = "t";
+		char* default_argv[] = { argv[0], f_flag, f_value };
+		args = parse_arguments(3, default_argv);
+	}
+
+	spot::formula f;
+	try {
+		f = spot::parse_formula(formula);
+	} catch (spot::parse_error& e) {
+		result = std::string("The input formula is invalid.\n") + e.what();
+		return 1;
+	}
+
+	Translator translator(options_from_arguments(args), capi_dict);
+	std::string stats;
+	spot::twa_graph_ptr aut;
+
+	try {
+		aut = translator.translate(f, &stats);
+	} catch (std::runtime_error& e) {
+		std::string what_str(e.what());
+
+		if (what_str.find("Too many acceptance sets used.") == 0) {
+			result = "LTL3TELA is unable to set more than 32 acceptance marks.\n";
+			return 32;
+		}
+		result = what_str + "\n";
+		return 3;
+	} catch (const char* e) {
+		result = std::string(e) + "\n";
+		return 3;
+	}
+
+	if (!aut) {
+		result = "No automaton was produced.\n";
+		return 3;
+	}
+
+	std::ostringstream out;
+	if (what == LTL3TELA_STATS) {
+		out << "states: " << aut->num_states() << '\n'
+			<< "edges: " << aut->num_edges() << '\n'
+			<< "acc-sets: " << aut->acc().num_sets() << '\n'
+			<< "deterministic: " << spot::is_universal(aut) << '\n'
+			<< stats;
+	} else if (args["o"] == "dot") {
+		spot::print_dot(out, aut);
+	} else {
+		spot::print_hoa(out, aut);
+		out << '\n';
+	}
+	result = out.str();
+
+	return 0;
+}
+
+int ltl3tela_translate(const char* formula, const char* flags, int what, char** result) {
+	std::string r;
+	int ret;
+
+	// no exception may leave the C interface
+	try {
+		ret = translate_to_string(formula, flags, what, r);
+	} catch (std::exception& e) {
+		r = std::string(e.what()) + "\n";
+		ret = 3;
+	} catch (...) {
+		r = "The translation failed.\n";
+		ret = 3;
+	}
+
+	if (result) {
+		*result = copy_to_c(r);
+	}
+
+	return ret;
+}
+
+void ltl3tela_free(char* result) {
+	std::free(result);
+}
+
+const char* ltl3tela_version(void) {
+	return LTL3TELA_VERSION;
+}
@@ -0,0 +1,64 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <chrono>
+#include "deadline.hpp"
+
+typedef std::chrono::steady_clock deadline_clock;
+
+static bool deadline_active = false;
+static deadline_clock::time_point deadline_end;
+static std::string cut_stage;
+
+deadline_exceeded::deadline_exceeded(const std::string& stage)
+	: std::runtime_error("The deadline was exceeded in " + stage + "."), stage(stage) {
+}
+
+const std::string& deadline_exceeded::get_stage() const {
+	return stage;
+}
+
+void start_deadline() {
+	deadline_active = o_deadline > 0;
+	deadline_end = deadline_clock::now() + std::chrono::milliseconds(o_deadline);
+	cut_stage.clear();
+}
+
+bool deadline_passed(const char* stage) {
+	if (!deadline_active || deadline_clock::now() < deadline_end) {
+		return false;
+	}
+
+	if (cut_stage.empty()) {
+		cut_stage = stage;
+	}
+
+	return true;
+}
+
+void check_deadline(const char* stage) {
+	if (deadline_passed(stage)) {
+		throw deadline_exceeded(stage);
+	}
+}
+
+const std::string& deadline_stage() {
+	return cut_stage;
+}
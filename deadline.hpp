@@ -0,0 +1,53 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+#include <stdexcept>
+#include <string>
+#include "utils.hpp"
+
+// the deadline of the running translation set by -T;
+// the hot loops check it and either throw deadline_exceeded
+// (if their partial result is useless) or finish early with a valid result
+
+class deadline_exceeded : public std::runtime_error {
+	std::string stage;
+public:
+	deadline_exceeded(const std::string& stage);
+
+	const std::string& get_stage() const;
+};
+
+// starts the countdown of o_deadline milliseconds (no deadline if 0)
+// and forgets the stage cut off in the previous translation
+void start_deadline();
+
+// returns true if the deadline has passed; the stage is remembered
+// as the one cut off if it is the first one
+bool deadline_passed(const char* stage);
+
+// throws deadline_exceeded if the deadline has passed
+void check_deadline(const char* stage);
+
+// returns the first stage cut off by the deadline or an empty string
+const std::string& deadline_stage();
+
+#endif
@@ -0,0 +1,154 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "frozen.hpp"
+#include "deadline.hpp"
+
+// the number of products found in tries and computed for them
+static unsigned long hits = 0;
+static unsigned long misses = 0;
+
+unsigned long product_hits() {
+	return hits;
+}
+
+unsigned long product_misses() {
+	return misses;
+}
+
+void reset_product_stats() {
+	hits = 0;
+	misses = 0;
+}
+
+product_trie::product_trie() : products(1) {
+}
+
+unsigned product_trie::find_child(unsigned node, unsigned rank) const {
+	auto it = children.find((uint64_t(node) << 32) | rank);
+	return it != children.end() ? it->second : -1U;
+}
+
+unsigned product_trie::add_child(unsigned node, unsigned rank) {
+	unsigned child = products.size();
+	products.emplace_back();
+	children.emplace((uint64_t(node) << 32) | rank, child);
+	return child;
+}
+
+edge_list& product_trie::get_product(unsigned node) {
+	return products[node];
+}
+
+std::vector<unsigned>& product_trie::get_targets_buffer() {
+	return targets_buffer;
+}
+
+void frozen_slaa::add_state(unsigned rank) {
+	state_offsets.push_back(state_offsets.back());
+	state_rank.push_back(rank);
+}
+
+unsigned frozen_slaa::states_count() const {
+	return state_rank.size();
+}
+
+unsigned frozen_slaa::first_edge(unsigned state_id) const {
+	return state_offsets[state_id];
+}
+
+const edge_list& frozen_slaa::get_edges() const {
+	return edges;
+}
+
+unsigned frozen_slaa::prefix_product(const std::set<unsigned>& state_ids, product_trie& trie, unsigned& last_state) const {
+	// the factors are the states with distinct sets of edges
+	// as pairs (rank, state), ordered by rank
+	std::vector<std::pair<unsigned, unsigned>> factors;
+	factors.reserve(state_ids.size());
+	for (auto state_id : state_ids) {
+		factors.emplace_back(state_rank[state_id], state_id);
+	}
+
+	std::sort(factors.begin(), factors.end());
+	factors.erase(std::unique(factors.begin(), factors.end(), [](const std::pair<unsigned, unsigned>& a, const std::pair<unsigned, unsigned>& b) {
+		return a.first == b.first;
+	}), factors.end());
+
+	if (factors.empty()) {
+		last_state = -1U;
+		return 0;
+	}
+
+	last_state = factors.back().second;
+	if (factors.size() > 1) {
+		check_deadline("product");
+	}
+
+	// multiply the product of the prefix by the factors from left to right;
+	// the edges come in the lexicographic order of the tuples of edges
+	// they are made of, as in SLAA::add_product
+	unsigned node = 0;
+	for (unsigned i = 0; i + 1 < factors.size(); ++i) {
+		unsigned rank = factors[i].first;
+		unsigned state_id = factors[i].second;
+
+		unsigned child = trie.find_child(node, rank);
+		if (child != -1U) {
+			++hits;
+			node = child;
+			continue;
+		}
+
+		++misses;
+		child = trie.add_child(node, rank);
+		auto& result = trie.get_product(child);
+
+		if (i == 0) {
+			for (unsigned e = first_edge(state_id); e < first_edge(state_id + 1); ++e) {
+				const auto& edge = edges.get_edge(e);
+				if (edge.label != bddfalse) {
+					auto targets = edges.get_targets(e);
+					result.add_edge(edge.label, targets.begin(), targets.end(), edge.marks);
+				}
+			}
+		} else {
+			check_deadline("product");
+
+			const auto& prefix = trie.get_product(node);
+			for (unsigned e0 = 0; e0 < prefix.size(); ++e0) {
+				const auto& edge0 = prefix.get_edge(e0);
+
+				for (unsigned e1 = first_edge(state_id); e1 < first_edge(state_id + 1); ++e1) {
+					const auto& edge1 = edges.get_edge(e1);
+
+					bdd label = edge0.label & edge1.label;
+					if (label != bddfalse) {
+						result.add_edge(label, prefix.get_targets(e0), edges.get_targets(e1), edge0.marks | edge1.marks);
+					}
+				}
+			}
+		}
+
+		node = child;
+	}
+
+	return node;
+}
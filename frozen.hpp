@@ -0,0 +1,231 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef FROZEN_H
+#define FROZEN_H
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <bddx.h>
+#include <spot/twa/acc.hh>
+
+// a view of a sorted range of state IDs
+class target_range {
+	const unsigned* first;
+	const unsigned* last;
+public:
+	target_range(const unsigned* first, const unsigned* last) : first(first), last(last) {
+	}
+
+	const unsigned* begin() const {
+		return first;
+	}
+
+	const unsigned* end() const {
+		return last;
+	}
+
+	unsigned size() const {
+		return last - first;
+	}
+
+	bool empty() const {
+		return first == last;
+	}
+
+	unsigned count(unsigned x) const {
+		return std::binary_search(first, last, x);
+	}
+};
+
+// an edge of an edge_list; its targets are the positions
+// [targets_begin, targets_end) of the targets array of the list
+struct frozen_edge {
+	bdd label;
+	unsigned targets_begin;
+	unsigned targets_end;
+	spot::acc_cond::mark_t marks;
+};
+
+// a list of edges with the targets of all of them stored in one array
+class edge_list {
+	std::vector<frozen_edge> edges;
+	std::vector<unsigned> targets;
+public:
+	// appends an edge with the given sorted range of targets
+	template<typename It> void add_edge(bdd label, It first, It last, spot::acc_cond::mark_t marks) {
+		unsigned targets_begin = targets.size();
+		targets.insert(targets.end(), first, last);
+		edges.push_back({ label, targets_begin, (unsigned)targets.size(), marks });
+	}
+
+	// appends an edge going to the union of t1 and t2;
+	// the ranges may not point to this list
+	void add_edge(bdd label, target_range t1, target_range t2, spot::acc_cond::mark_t marks) {
+		unsigned targets_begin = targets.size();
+		std::set_union(t1.begin(), t1.end(), t2.begin(), t2.end(), std::back_inserter(targets));
+		edges.push_back({ label, targets_begin, (unsigned)targets.size(), marks });
+	}
+
+	const frozen_edge& get_edge(unsigned edge_id) const {
+		return edges[edge_id];
+	}
+
+	// the range is invalidated when an edge is added
+	target_range get_targets(unsigned edge_id) const {
+		const unsigned* data = targets.data();
+		return target_range(data + edges[edge_id].targets_begin, data + edges[edge_id].targets_end);
+	}
+
+	unsigned size() const {
+		return edges.size();
+	}
+
+	// removes the edges but keeps the allocated memory
+	void clear() {
+		edges.clear();
+		targets.clear();
+	}
+};
+
+// the products of the edges of sequences of states computed during one
+// subset construction; a node of the trie holds the product for the sequence
+// of states (given by their ranks) on the path from the root
+class product_trie {
+	// the products; the deque keeps them in place when a node is added
+	std::deque<edge_list> products;
+
+	// maps a node and a rank to the child node
+	std::unordered_map<uint64_t, unsigned> children;
+
+	// the targets of the edge of a product being passed on
+	std::vector<unsigned> targets_buffer;
+public:
+	// the root is the empty sequence
+	product_trie();
+
+	// returns the child of the node for the rank or -1U if it does not exist
+	unsigned find_child(unsigned node, unsigned rank) const;
+
+	// adds the child of the node for the rank with an empty product
+	unsigned add_child(unsigned node, unsigned rank);
+
+	edge_list& get_product(unsigned node);
+
+	std::vector<unsigned>& get_targets_buffer();
+};
+
+// returns the number of products found in product tries and computed for them
+// since the last call of reset_product_stats
+unsigned long product_hits();
+unsigned long product_misses();
+void reset_product_stats();
+
+// a read-only snapshot of an SLAA packed into contiguous arrays,
+// created by SLAA::freeze and used by the subset construction
+class frozen_slaa {
+	// the edges of all states; the edges of a state are consecutive
+	// and ordered by their IDs in the SLAA
+	edge_list edges;
+
+	// the edges of state s are [state_offsets[s], state_offsets[s + 1])
+	std::vector<unsigned> state_offsets = { 0 };
+
+	// states with the same set of edges have the same rank;
+	// ranks follow the order of the sets of edge IDs in the SLAA
+	std::vector<unsigned> state_rank;
+
+	// returns the node of the trie with the product of all but the last
+	// of the given states ordered by rank (the root for one state) and sets
+	// last_state to the last one (-1U if there are no states)
+	unsigned prefix_product(const std::set<unsigned>& state_ids, product_trie& trie, unsigned& last_state) const;
+public:
+	// starts a new state; the following edges belong to it
+	void add_state(unsigned rank);
+
+	// adds an edge to the last state
+	template<typename It> void add_edge(bdd label, It first, It last, spot::acc_cond::mark_t marks) {
+		edges.add_edge(label, first, last, marks);
+		++state_offsets.back();
+	}
+
+	unsigned states_count() const;
+
+	// the IDs of edges of the state are [first_edge(state_id), first_edge(state_id + 1))
+	unsigned first_edge(unsigned state_id) const;
+
+	const edge_list& get_edges() const;
+
+	// computes the mark-preserving product of the edges of the given states
+	// and calls emit(label, targets, marks) for each of its edges with
+	// a satisfiable label, in the order SLAA::add_product adds them for
+	// the sets of edges of these states; the products of prefixes of the
+	// states are taken from the trie, but the edges of the whole product
+	// are not stored anywhere
+	template<typename F> void product(const std::set<unsigned>& state_ids, product_trie& trie, F emit) const {
+		unsigned last_state;
+		unsigned node = prefix_product(state_ids, trie, last_state);
+		if (last_state == -1U) {
+			return;
+		}
+
+		if (node == 0) {
+			// the product of one state are its edges
+			for (unsigned e = first_edge(last_state); e < first_edge(last_state + 1); ++e) {
+				const auto& edge = edges.get_edge(e);
+				if (edge.label != bddfalse) {
+					emit(edge.label, edges.get_targets(e), edge.marks);
+				}
+			}
+
+			return;
+		}
+
+		const auto& prefix = trie.get_product(node);
+		auto& targets = trie.get_targets_buffer();
+
+		for (unsigned e0 = 0; e0 < prefix.size(); ++e0) {
+			const auto& edge0 = prefix.get_edge(e0);
+			auto targets0 = prefix.get_targets(e0);
+
+			for (unsigned e1 = first_edge(last_state); e1 < first_edge(last_state + 1); ++e1) {
+				const auto& edge1 = edges.get_edge(e1);
+
+				// nothing is computed for the products with false label
+				bdd label = edge0.label & edge1.label;
+				if (label == bddfalse) {
+					continue;
+				}
+
+				auto targets1 = edges.get_targets(e1);
+				targets.clear();
+				std::set_union(targets0.begin(), targets0.end(), targets1.begin(), targets1.end(), std::back_inserter(targets));
+
+				emit(label, target_range(targets.data(), targets.data() + targets.size()), edge0.marks | edge1.marks);
+			}
+		}
+	}
+};
+
+#endif
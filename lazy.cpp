@@ -0,0 +1,195 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "lazy.hpp"
+
+lazy_na_state::lazy_na_state(unsigned id) : id(id) {
+}
+
+unsigned lazy_na_state::get_id() const {
+	return id;
+}
+
+int lazy_na_state::compare(const spot::state* other) const {
+	auto other_id = static_cast<const lazy_na_state*>(other)->id;
+	return id < other_id ? -1 : (id > other_id ? 1 : 0);
+}
+
+size_t lazy_na_state::hash() const {
+	return id;
+}
+
+lazy_na_state* lazy_na_state::clone() const {
+	return new lazy_na_state(id);
+}
+
+lazy_na_succ_iterator::lazy_na_succ_iterator(const std::vector<lazy_na_edge>& edges) : edges(edges), pos(0) {
+}
+
+bool lazy_na_succ_iterator::first() {
+	pos = 0;
+	return !done();
+}
+
+bool lazy_na_succ_iterator::next() {
+	++pos;
+	return !done();
+}
+
+bool lazy_na_succ_iterator::done() const {
+	return pos >= edges.size();
+}
+
+const spot::state* lazy_na_succ_iterator::dst() const {
+	return new lazy_na_state(edges[pos].dst);
+}
+
+bdd lazy_na_succ_iterator::cond() const {
+	return edges[pos].cond;
+}
+
+spot::acc_cond::mark_t lazy_na_succ_iterator::acc() const {
+	return edges[pos].acc;
+}
+
+lazy_na::lazy_na(SLAA* slaa) : spot::twa(slaa->spot_aut->get_dict()), slaa(slaa), sets_index(&sets), init_id(-1U) {
+	copy_ap_of(slaa->spot_aut);
+
+	auto acr = slaa->mark_transformation(tgba_mark_owners);
+	sibling_of_removed_fin = siblings_of_removed_fin(acr, tgba_mark_owners);
+
+	// only the marks of the acceptance condition are kept on the edges
+	auto used_marks = acceptance_marks(acr, tgba_mark_owners);
+
+	acc_mark mark_counter = 0;
+	for (auto old_mark : used_marks) {
+		mark_conversion[old_mark] = mark_counter;
+		++mark_counter;
+	}
+
+	if (!acr.empty()) {
+		set_acceptance(used_marks.size(), na_acceptance(acr, tgba_mark_owners, used_marks, mark_conversion));
+	}
+
+	slaa->share_edges();
+	frozen = slaa->freeze();
+
+	std::vector<unsigned> init_ids;
+	for (auto& init_set : slaa->get_init_sets()) {
+		std::vector<unsigned> init_states(init_set.begin(), init_set.end());
+		init_ids.push_back(config_id(target_range(init_states.data(), init_states.data() + init_states.size())));
+	}
+
+	if (init_ids.size() == 1) {
+		init_id = init_ids[0];
+	} else {
+		// more initial configurations are merged to one new state
+		for (auto id : init_ids) {
+			const auto& edges = get_successors(id);
+			init_edges.insert(init_edges.end(), edges.begin(), edges.end());
+		}
+	}
+}
+
+lazy_na::~lazy_na() {
+	delete slaa;
+}
+
+unsigned lazy_na::config_id(target_range state_set) const {
+	auto h = config_index::hash(state_set);
+	auto id = sets_index.find(state_set, h);
+	if (id == -1U) {
+		id = sets_index.size();
+		sets_index.add(state_set, h);
+	}
+
+	return id;
+}
+
+const std::vector<lazy_na_edge>& lazy_na::get_successors(unsigned id) const {
+	if (id == -1U) {
+		return init_edges;
+	}
+
+	while (successors.size() <= id) {
+		successors.emplace_back();
+		explored.push_back(false);
+	}
+
+	auto& edges = successors[id];
+	if (!explored[id]) {
+		explored[id] = true;
+		// the product may add new configurations, work on a copy
+		std::set<unsigned> source_set = sets[id];
+
+		if (source_set.empty()) {
+			// if the state is ∅, add a true loop
+			edges.push_back({ bdd_true(), id, {} });
+		} else {
+			frozen.product(source_set, products, [&](bdd label, target_range targets, spot::acc_cond::mark_t marks) {
+				unsigned target_id = config_id(targets);
+				auto edge_marks = assign_owner_marks(frozen, tgba_mark_owners, sibling_of_removed_fin, label, sets[target_id], mark_set(marks));
+
+				spot::acc_cond::mark_t marks_relabelled = {};
+				for (auto mark : edge_marks) {
+					auto it = mark_conversion.find(mark);
+					if (it != mark_conversion.end()) {
+						marks_relabelled.set(it->second);
+					}
+				}
+
+				edges.push_back({ label, target_id, marks_relabelled });
+			});
+		}
+	}
+
+	return edges;
+}
+
+const spot::state* lazy_na::get_init_state() const {
+	return new lazy_na_state(init_id);
+}
+
+spot::twa_succ_iterator* lazy_na::succ_iter(const spot::state* s) const {
+	return new lazy_na_succ_iterator(get_successors(static_cast<const lazy_na_state*>(s)->get_id()));
+}
+
+std::string lazy_na::format_state(const spot::state* s) const {
+	auto id = static_cast<const lazy_na_state*>(s)->get_id();
+	return id == -1U ? "init" : set_to_str(sets[id]);
+}
+
+unsigned lazy_na::explored_states() const {
+	return sets.size();
+}
+
+lazy_na_ptr make_lazy_nondeterministic(spot::formula f, spot::bdd_dict_ptr dict) {
+	auto slaa = make_alternating(simplify_formula(f), dict);
+
+	try {
+		slaa->remove_unreachable_states();
+		slaa->remove_unnecessary_marks();
+
+		return std::make_shared<lazy_na>(slaa);
+	} catch (...) {
+		// the NA takes the ownership only once it is constructed
+		delete slaa;
+		throw;
+	}
+}
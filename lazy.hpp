@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAZY_H
+#define LAZY_H
+#include <deque>
+#include <spot/twa/twa.hh>
+#include "nondeterministic.hpp"
+
+// a state of lazy_na: the ID of a configuration (set of SLAA states)
+// or -1U for the merged initial state
+class lazy_na_state : public spot::state {
+	unsigned id;
+public:
+	lazy_na_state(unsigned id);
+
+	unsigned get_id() const;
+
+	int compare(const spot::state* other) const override;
+	size_t hash() const override;
+	lazy_na_state* clone() const override;
+};
+
+struct lazy_na_edge {
+	bdd cond;
+	unsigned dst;
+	spot::acc_cond::mark_t acc;
+};
+
+class lazy_na_succ_iterator : public spot::twa_succ_iterator {
+	const std::vector<lazy_na_edge>& edges;
+	unsigned pos;
+public:
+	lazy_na_succ_iterator(const std::vector<lazy_na_edge>& edges);
+
+	bool first() override;
+	bool next() override;
+	bool done() const override;
+	const spot::state* dst() const override;
+	bdd cond() const override;
+	spot::acc_cond::mark_t acc() const override;
+};
+
+// the NA of the given SLAA built on the fly: the successors of a configuration
+// are computed (as products of the SLAA edges) when they are asked for
+// the first time and kept for later; no domination or state merging
+// is applied, so the automaton may be bigger than make_nondeterministic's
+class lazy_na : public spot::twa {
+	SLAA* slaa;
+	frozen_slaa frozen;
+
+	// a map { mark => SLAA state } of Fin-marks removed from NA
+	std::map<acc_mark, unsigned> tgba_mark_owners;
+	std::map<acc_mark, acc_mark> sibling_of_removed_fin;
+	// the marks used by the acceptance condition and their new numbers
+	std::map<acc_mark, acc_mark> mark_conversion;
+
+	// the configurations discovered so far
+	mutable std::vector<std::set<unsigned>> sets;
+	mutable config_index sets_index;
+	mutable product_trie products;
+	// the successors of the configurations by their IDs;
+	// deque keeps the references held by the iterators valid
+	mutable std::deque<std::vector<lazy_na_edge>> successors;
+	mutable std::vector<bool> explored;
+
+	// the ID of the initial configuration or -1U if there are more of them
+	unsigned init_id;
+	// the successors of the merged initial state
+	std::vector<lazy_na_edge> init_edges;
+
+	unsigned config_id(target_range state_set) const;
+	const std::vector<lazy_na_edge>& get_successors(unsigned id) const;
+public:
+	// takes the ownership of the SLAA
+	lazy_na(SLAA* slaa);
+	~lazy_na();
+
+	const spot::state* get_init_state() const override;
+	spot::twa_succ_iterator* succ_iter(const spot::state* s) const override;
+	std::string format_state(const spot::state* s) const override;
+
+	// returns the number of configurations discovered so far
+	unsigned explored_states() const;
+};
+
+typedef std::shared_ptr<lazy_na> lazy_na_ptr;
+
+// simplifies and translates the formula to SLAA (as Translator::make_slaa does)
+// and returns its NA built on the fly,
+// e.g. for spot::otf_product or an emptiness check
+lazy_na_ptr make_lazy_nondeterministic(spot::formula f, spot::bdd_dict_ptr dict);
+
+#endif
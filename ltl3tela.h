@@ -0,0 +1,52 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* The C interface of libltl3tela.so, e.g. for Python's ctypes. */
+
+#ifndef LTL3TELA_C_H
+#define LTL3TELA_C_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* what ltl3tela_translate returns in *result */
+#define LTL3TELA_HOA 0		/* the automaton (HOA, or DOT with -o dot) */
+#define LTL3TELA_STATS 1	/* lines "states: n", "edges: n", "acc-sets: n", */
+							/* "deterministic: 0|1" followed by the -x1 statistics */
+
+/* Translates the formula with the flags given as on the command line
+   (e.g. "-D1 -n0"; -f, -L, -S, -m and -p are not accepted).
+   Returns the exit code of the command line tool (0 on success).
+   *result receives the output, or the error message if the translation failed;
+   it has to be released by ltl3tela_free.
+   The BDD package is initialized by the first call. */
+int ltl3tela_translate(const char* formula, const char* flags, int what, char** result);
+
+/* releases a string returned by ltl3tela_translate */
+void ltl3tela_free(char* result);
+
+/* returns the version of LTL3TELA */
+const char* ltl3tela_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -19,23 +19,53 @@
 
 #include "nondeterministic.hpp"
 
-// Returns the id for a set of SLAA states
-// It creates a new state if not present
-unsigned get_state_id_for_set(spot::twa_graph_ptr aut, std::set<unsigned> state_set) {
-	auto sets = aut->get_named_prop<std::vector<std::set<unsigned>>>("state-sets");
+config_index::config_index(std::vector<std::set<unsigned>>* sets) : sets(sets) {
+}
+
+size_t config_index::hash(target_range state_set) {
+	size_t h = state_set.size();
+	for (auto state : state_set) {
+		h ^= state + 0x9e3779b9 + (h << 6) + (h >> 2);
+	}
 
-	for (unsigned i = 0; i < sets->size(); ++i) {
-		std::set<unsigned> candidate = (*sets)[i];
-		if (candidate == state_set) {
-			return i;
+	return h;
+}
+
+unsigned config_index::find(target_range state_set, size_t h) const {
+	auto range = ids.equal_range(h);
+	for (auto it = range.first; it != range.second; ++it) {
+		const auto& candidate = (*sets)[it->second];
+		if (candidate.size() == state_set.size() && std::equal(candidate.begin(), candidate.end(), state_set.begin())) {
+			return it->second;
 		}
 	}
 
+	return -1U;
+}
+
+void config_index::add(target_range state_set, size_t h) {
+	ids.emplace(h, sets->size());
+	sets->emplace_back(state_set.begin(), state_set.end());
+}
+
+unsigned config_index::size() const {
+	return sets->size();
+}
+
+// Returns the id for a set of SLAA states
+// It creates a new state if not present
+unsigned get_state_id_for_set(spot::twa_graph_ptr aut, config_index& index, target_range state_set) {
+	auto h = config_index::hash(state_set);
+	auto id = index.find(state_set, h);
+	if (id != -1U) {
+		return id;
+	}
+
 	unsigned i = aut->new_state();
-	if (i != sets->size()) {
+	if (i != index.size()) {
 		throw "Unexpected index.";
 	} else {
-		sets->push_back(state_set);
+		index.add(state_set, h);
 		return i;
 	}
 }
@@ -55,8 +85,122 @@ std::string set_to_str(std::set<unsigned> set) {
 	return name;
 }
 
+std::map<acc_mark, acc_mark> siblings_of_removed_fin(const SLAA::ac_representation& acr, const std::map<acc_mark, unsigned>& tgba_mark_owners) {
+	std::map<acc_mark, acc_mark> sibling_of_removed_fin;
+	for (auto& disj : acr) {
+		for (auto& conj : disj) {
+			for (auto& pair : conj) {
+				if (tgba_mark_owners.count(pair.first) > 0) {
+					sibling_of_removed_fin.insert(pair);
+				}
+			}
+		}
+	}
+
+	return sibling_of_removed_fin;
+}
+
+mark_set assign_owner_marks(const frozen_slaa& frozen, const std::map<acc_mark, unsigned>& tgba_mark_owners, const std::map<acc_mark, acc_mark>& sibling_of_removed_fin, bdd label, const std::set<unsigned>& target_set, mark_set marks) {
+	const auto& frozen_edges = frozen.get_edges();
+
+	for (auto& rec : tgba_mark_owners) {
+		// is the transition marked by the appropriate mark?
+		if (marks.count(rec.first) == 0) {
+			// no; does this edge go somewhere else than the source state?
+			if (target_set.count(rec.second) == 0) {
+				// yes so add the sibling
+				marks.insert(sibling_of_removed_fin.at(rec.first));
+			} else {
+				// find some edge f from target state that satisfies:
+				// 1) f goes to subset of target_set not containing the owner of mark
+				// 2) f.label ⊆ current edge.label
+				for (unsigned f_edge_id = frozen.first_edge(rec.second); f_edge_id < frozen.first_edge(rec.second + 1); ++f_edge_id) {
+					auto f_targets = frozen_edges.get_targets(f_edge_id);
+
+					if (f_targets.count(rec.second) == 0
+						&& std::includes(target_set.begin(), target_set.end(), f_targets.begin(), f_targets.end())
+						&& ((label & bdd_not(frozen_edges.get_edge(f_edge_id).label)) == bdd_false())
+					) {
+						marks.insert(sibling_of_removed_fin.at(rec.first));
+						break;
+					}
+				}
+
+			}
+		} else {
+			// yes, remove it
+			marks.erase(rec.first);
+		}
+	}
+
+	return marks;
+}
+
+std::set<acc_mark> acceptance_marks(const SLAA::ac_representation& acr, const std::map<acc_mark, unsigned>& tgba_mark_owners) {
+	std::set<acc_mark> marks;
+	for (auto& disj : acr) {
+		for (auto& conj : disj) {
+			for (auto& pair : conj) {
+				if (tgba_mark_owners.count(pair.first) == 0) {
+					marks.insert(pair.first);
+				}
+				marks.insert(pair.second);
+			}
+		}
+	}
+
+	return marks;
+}
+
+spot::acc_cond::acc_code na_acceptance(const SLAA::ac_representation& acr, const std::map<acc_mark, unsigned>& tgba_mark_owners, const std::set<acc_mark>& used_marks, const std::map<acc_mark, acc_mark>& mark_conversion) {
+	auto acc = spot::acc_cond::acc_code::t();
+
+	for (auto& disj : acr) {
+		auto disj_f = spot::acc_cond::acc_code::f();
+
+		bool not_having_true = false;
+		for (auto& conj : disj) {
+			auto conj_f = spot::acc_cond::acc_code::t();
+
+			for (auto& pair : conj) {
+				if (tgba_mark_owners.count(pair.first) > 0) {
+					if (used_marks.count(pair.second) > 0) {
+						conj_f &= spot::acc_cond::acc_code::inf(spot::acc_cond::mark_t({ mark_conversion.at(pair.second) }));
+					} else {
+						// Inf(unused mark) can be never satisfied
+						conj_f &= spot::acc_cond::acc_code::f();
+					}
+					not_having_true = true;
+				} else {
+					bool fin_used = used_marks.count(pair.first) > 0;
+					bool inf_used = used_marks.count(pair.second) > 0;
+
+					if (fin_used && inf_used) {
+						conj_f &= spot::acc_cond::acc_code::fin(spot::acc_cond::mark_t({ mark_conversion.at(pair.first) })) | spot::acc_cond::acc_code::inf(spot::acc_cond::mark_t({ mark_conversion.at(pair.second) }));
+						not_having_true = true;
+					} else if (fin_used) {
+						// Inf cannot be satisfied, so we rely on Fin
+						conj_f &= spot::acc_cond::acc_code::fin(spot::acc_cond::mark_t({ mark_conversion.at(pair.first) }));
+						not_having_true = true;
+					}
+				}
+			}
+			disj_f |= conj_f;
+		}
+
+		if (not_having_true) {
+			acc &= disj_f;
+		}
+	}
+
+	return acc;
+}
+
+candidate_pruned::candidate_pruned() : std::runtime_error("The candidate automaton exceeded the state bound.") {
+}
+
 // Converts a given SLAA to NA
-spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
+spot::twa_graph_ptr make_nondeterministic(SLAA* slaa, unsigned state_bound) {
 	unsigned last_inserted = 0;
 
 	// create an empty automaton
@@ -70,6 +214,7 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 	// create a map of names
 	auto sets = new std::vector<std::set<unsigned>>;
 	aut->set_named_prop<std::vector<std::set<unsigned>>>("state-sets", sets);
+	config_index sets_index(sets);
 
 	// a map { mark => SLAA state } of Fin-marks removed from NA
 	// filled only if -t flag is active
@@ -77,11 +222,15 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 	// acr is a representation of the final acceptance condition
 	auto acr = slaa->mark_transformation(tgba_mark_owners);
 
-	auto& ac = aut->acc();
+	// the SLAA does not change from now on; states with equal edges
+	// get equal sets of edge IDs and are multiplied only once in the product
+	slaa->share_edges();
+	const auto frozen = slaa->freeze();
 
 	std::queue<unsigned> q;
 
-	NA* nha = new NA(sets);
+	// freed also when the product is cut off by the deadline
+	std::unique_ptr<NA> nha(new NA(sets));
 	// copy the Inf-marks from SLAA
 	nha->remember_inf_mark(slaa->get_inf_marks());
 	// put initial configurations into queue, create states
@@ -89,7 +238,8 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 	std::set<unsigned> na_init_states;
 
 	for(auto& init_set : slaa->get_init_sets()) {
-		auto index = get_state_id_for_set(aut, init_set);
+		std::vector<unsigned> init_states(init_set.begin(), init_set.end());
+		auto index = get_state_id_for_set(aut, sets_index, target_range(init_states.data(), init_states.data() + init_states.size()));
 
 		q.push(index);
 		// ignore the return value, just make sure we create the state
@@ -98,61 +248,97 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 		last_inserted = index;
 	}
 
-	// map { mark => set of owner SLAA states } of Fin-marks removed from NA
-	std::map<acc_mark, std::set<unsigned>> removed_fin_marks;
-
 	// map { mark => mark } of the siblings of removed Fin-marks
-	std::map<acc_mark, acc_mark> sibling_of_removed_fin;
-	for (auto& disj : acr) {
-		auto disj_f = spot::acc_cond::acc_code::f();
+	auto sibling_of_removed_fin = siblings_of_removed_fin(acr, tgba_mark_owners);
 
-		for (auto& conj : disj) {
-			for (auto& pair : conj) {
-				if (tgba_mark_owners.count(pair.first) > 0) {
-					sibling_of_removed_fin.insert(pair);
-				}
-			}
-		}
-	}
+	// the products of the edges of sequences of SLAA states; the configurations
+	// with a common prefix share the product of the prefix
+	product_trie products;
 
 	// while the queue is not empty, create a state using the subset construction
 	while(!q.empty()) {
+		if (deadline_passed("make_nondeterministic")) {
+			throw deadline_exceeded("make_nondeterministic");
+		}
+
+		if (state_bound > 0 && aut->num_states() > state_bound) {
+			throw candidate_pruned();
+		}
+
 		auto source_id = q.front();
 		q.pop();
 		std::set<unsigned> source_sets = (*sets) [source_id];
 
 		if (source_sets.size() == 0) {
 			// if the state is ∅, add a true loop
-			nha->add_edge(nha->get_state_id(source_id), bdd_true(), std::set<unsigned>({ nha->get_state_id(source_id) }));
-		} else {
-			// count the product
-			std::set<std::set<unsigned>> edges_for_product;
-			for (auto& state_id : source_sets) {
-				edges_for_product.insert(slaa->get_state_edges(state_id));
-			}
+			nha->add_edge(nha->get_state_id(source_id), bdd_true(), nha->get_state_id(source_id));
+		} else if (o_antichain) {
+			unsigned source_state = nha->get_state_id(source_id);
+
+			// with -A, the product edges are first kept aside as an antichain
+			// w.r.t. domination; only the targets of the edges left in it
+			// become states, the others are never explored
+			edge_list antichain;
+			std::vector<bool> dominated;
+
+			frozen.product(source_sets, products, [&](bdd label, target_range targets, spot::acc_cond::mark_t marks) {
+				mark_set edge_marks(marks);
+
+				for (unsigned i = 0; i < antichain.size(); ++i) {
+					const auto& other = antichain.get_edge(i);
+					if (!dominated[i] && nha->dominates(other.label, antichain.get_targets(i), mark_set(other.marks), label, targets, edge_marks)) {
+						return;
+					}
+				}
+
+				for (unsigned i = 0; i < antichain.size(); ++i) {
+					const auto& other = antichain.get_edge(i);
+					if (!dominated[i] && nha->dominates(label, targets, edge_marks, other.label, antichain.get_targets(i), mark_set(other.marks))) {
+						dominated[i] = true;
+					}
+				}
 
-			std::set<unsigned> product_edges = slaa->product(edges_for_product, true);
+				antichain.add_edge(label, targets.begin(), targets.end(), marks);
+				dominated.push_back(false);
+			});
 
-			// check each successor and if needed, create a new state and add to queue
-			for (auto& edge_id : product_edges) {
-				auto label = slaa->get_edge(edge_id)->get_label();
-				// do not add the false edges
-				if (label == bddfalse) {
+			for (unsigned i = 0; i < antichain.size(); ++i) {
+				if (dominated[i]) {
 					continue;
 				}
 
-				std::set<unsigned> targets = slaa->get_edge(edge_id)->get_targets();
+				const auto& edge = antichain.get_edge(i);
+				unsigned target_id = get_state_id_for_set(aut, sets_index, antichain.get_targets(i));
+				if (target_id > last_inserted) {
+					last_inserted = target_id;
+					q.push(target_id);
+				}
+
+				nha->add_edge(source_state, edge.label, nha->get_state_id(target_id), mark_set(edge.marks));
+			}
+		} else {
+			unsigned source_state = nha->get_state_id(source_id);
+
+			// count the product; check each successor and if needed,
+			// create a new state and add to queue
+			frozen.product(source_sets, products, [&](bdd label, target_range targets, spot::acc_cond::mark_t marks) {
+				mark_set edge_marks(marks);
+
+				// an edge dominated by an edge of the state would not be added,
+				// so its target is not created either
+				if (nha->is_dominated(source_state, label, targets, edge_marks)) {
+					return;
+				}
 
 				// creates state if not existe for given set
-				unsigned target_id = get_state_id_for_set(aut, targets);
+				unsigned target_id = get_state_id_for_set(aut, sets_index, targets);
 				if (target_id > last_inserted) {
 					last_inserted = target_id;
 					q.push(target_id);
 				}
 
-				auto marks = slaa->get_edge(edge_id)->get_marks();
-				nha->add_edge(nha->get_state_id(source_id), label, std::set<unsigned>({ nha->get_state_id(target_id) }), marks);
-			}
+				nha->add_edge(source_state, label, nha->get_state_id(target_id), edge_marks);
+			});
 		}
 	}
 
@@ -167,8 +353,8 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 
 		for (auto old_init_state : na_init_states) {
 			// each transition of former initial state is copied
-			for (auto edge_id : nha->get_state_edges(old_init_state)) {
-				nha->add_edge(nha_init_state_id, edge_id);
+			for (auto& edge : nha->get_state_edges(old_init_state)) {
+				nha->add_edge(nha_init_state_id, edge.label, edge.dst, edge.marks);
 			}
 		}
 	}
@@ -197,50 +383,16 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 	// assign the marks as LTL2BA does
 	for (unsigned st_id = 0, st_count = nha->states_count(); st_id < st_count; ++st_id) {
 		auto source_id = nha->state_name(st_id);
+		// the edges of the state are replaced in the loop, iterate over a copy
+		auto edges = nha->get_state_edges(st_id);
 
-		for (auto& edge_id : nha->get_state_edges(st_id)) {
-			auto edge = nha->get_edge(edge_id);
-
-			auto targets = edge->get_targets();
-			auto target_id = nha->state_name(*(targets.begin()));
-			auto label = edge->get_label();
-			auto marks = edge->get_marks();
-			auto target_set = (*sets)[target_id];
-
-			for (auto& rec : tgba_mark_owners) {
-				// is the transition marked by the appropriate mark?
-				if (marks.count(rec.first) == 0) {
-					// no; does this edge go somewhere else than the source state?
-					if (target_set.count(rec.second) == 0) {
-						// yes so add the sibling
-						marks.insert(sibling_of_removed_fin[rec.first]);
-					} else {
-						// find some edge f from target state that satisfies:
-						// 1) f goes to subset of target_set not containing the owner of mark
-						// 2) f.label ⊆ current edge.label
-						for (auto& f_edge_id : slaa->get_state_edges(rec.second)) {
-							auto f_edge = slaa->get_edge(f_edge_id);
-							auto f_targets = f_edge->get_targets();
-
-							if (f_targets.count(rec.second) == 0
-								&& std::includes(target_set.begin(), target_set.end(), f_targets.begin(), f_targets.end())
-								&& ((label & bdd_not(f_edge->get_label())) == bdd_false())
-							) {
-								marks.insert(sibling_of_removed_fin[rec.first]);
-								break;
-							}
-						}
-
-					}
-				} else {
-					// yes, remove it
-					marks.erase(rec.first);
-				}
-			}
+		for (auto& edge : edges) {
+			auto target_id = nha->state_name(edge.dst);
+			auto marks = assign_owner_marks(frozen, tgba_mark_owners, sibling_of_removed_fin, edge.label, (*sets)[target_id], edge.marks);
 
 			// remove old edge and add the updated one
-			nha->remove_edge(source_id, edge_id);
-			nha->add_edge(source_id, label, targets, marks);
+			nha->remove_edge(source_id, edge);
+			nha->add_edge(source_id, edge.label, edge.dst, marks);
 		}
 	}
 
@@ -261,9 +413,8 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 	std::set<acc_mark> used_marks;
 
 	for (unsigned st_id = 0, st_count = nha->states_count(); st_id < st_count; ++st_id) {
-		for (auto& edge_id : nha->get_state_edges(st_id)) {
-			auto j = nha->get_edge(edge_id)->get_marks();
-			used_marks.insert(j.begin(), j.end());
+		for (auto& edge : nha->get_state_edges(st_id)) {
+			used_marks.insert(edge.marks.begin(), edge.marks.end());
 		}
 	}
 
@@ -279,69 +430,145 @@ spot::twa_graph_ptr make_nondeterministic(SLAA* slaa) {
 	aut->set_init_state(nha->state_name(nha->get_init_state()));
 
 	// build the acceptance condition
-	for (auto& disj : acr) {
-		auto disj_f = spot::acc_cond::acc_code::f();
+	if (!acr.empty()) {
+		aut->set_acceptance(used_marks.size(), na_acceptance(acr, tgba_mark_owners, used_marks, mark_conversion));
+	}
 
-		bool not_having_true = false;
-		for (auto& conj : disj) {
-			auto conj_f = spot::acc_cond::acc_code::t();
+	// now we can finally create the Spot structure
+	for (unsigned st_id = 0, st_count = nha->states_count(); st_id < st_count; ++st_id) {
+		auto source_id = nha->state_name(st_id);
 
-			for (auto& pair : conj) {
-				if (tgba_mark_owners.count(pair.first) > 0) {
-					if (used_marks.count(pair.second) > 0) {
-						conj_f &= ac.inf(spot::acc_cond::mark_t({ mark_conversion[pair.second] }));
-					} else {
-						// Inf(unused mark) can be never satisfied
-						conj_f &= spot::acc_cond::acc_code::f();
-					}
-					not_having_true = true;
-				} else {
-					bool fin_used = used_marks.count(pair.first) > 0;
-					bool inf_used = used_marks.count(pair.second) > 0;
+		for (auto& edge : nha->get_state_edges(st_id)) {
+			auto target_id = nha->state_name(edge.dst);
 
-					if (fin_used && inf_used) {
-						conj_f &= ac.fin(spot::acc_cond::mark_t({ mark_conversion[pair.first] })) | ac.inf(spot::acc_cond::mark_t({ mark_conversion[pair.second] }));
-						not_having_true = true;
-					} else if (fin_used) {
-						// Inf cannot be satisfied, so we rely on Fin
-						conj_f &= ac.fin(spot::acc_cond::mark_t({ mark_conversion[pair.first] }));
-						not_having_true = true;
-					}
-				}
+			spot::acc_cond::mark_t marks_relabelled = {};
+			for (auto mark : edge.marks) {
+				marks_relabelled.set(mark_conversion[mark]);
 			}
-			disj_f |= conj_f;
+
+			aut->new_edge(source_id, target_id, edge.label, marks_relabelled);
 		}
+	}
 
-		if (not_having_true) {
-			ac.set_acceptance(ac.get_acceptance() & disj_f);
+	aut = spot::scc_filter(aut);
+	aut = try_postprocessing(aut);
+
+	return aut;
+}
+
+spot::twa_graph_ptr build_slaa_candidate(spot::formula f, spot::bdd_dict_ptr dict) {
+	auto slaa = make_alternating(f, dict);
+
+	spot::twa_graph_ptr nwa;
+	try {
+		slaa->remove_unreachable_states();
+		slaa->remove_unnecessary_marks();
+
+		nwa = make_nondeterministic(slaa);
+	} catch (...) {
+		delete slaa;
+		throw;
+	}
+
+	delete slaa;
+
+	return nwa;
+}
+
+spot::twa_graph_ptr build_spot_candidate(spot::formula f, spot::bdd_dict_ptr dict) {
+	spot::twa_graph_ptr nwa;
+
+	if (dict) {
+		spot::translator ltl2tgba(dict);
+		if (o_deterministic) {
+			ltl2tgba.set_pref(spot::postprocessor::Deterministic);
+		}
+		ltl2tgba.set_type(spot::postprocessor::Generic);
+		ltl2tgba.set_level(spot::postprocessor::High);
+		nwa = ltl2tgba.run(f);
+	} else {
+		spot::translator ltl2tgba;
+		if (o_deterministic) {
+			ltl2tgba.set_pref(spot::postprocessor::Deterministic);
 		}
-		aut->set_acceptance(used_marks.size(), ac.get_acceptance());
+		ltl2tgba.set_type(spot::postprocessor::Generic);
+		ltl2tgba.set_level(spot::postprocessor::High);
+		nwa = ltl2tgba.run(f);
 	}
 
-	// now we can finally create the Spot structure
-	for (unsigned st_id = 0, st_count = nha->states_count(); st_id < st_count; ++st_id) {
-		auto source_id = nha->state_name(st_id);
+	return try_postprocessing(nwa);
+}
 
-		for (auto& edge_id : nha->get_state_edges(st_id)) {
-			auto edge = nha->get_edge(edge_id);
+spot::twa_graph_ptr build_fallback_candidate(spot::formula f, spot::bdd_dict_ptr dict) {
+	spot::translator ltl2tgba(dict ? dict : spot::make_bdd_dict());
+	ltl2tgba.set_type(spot::postprocessor::Generic);
+	ltl2tgba.set_level(spot::postprocessor::Low);
 
-			auto target_id = nha->state_name(*(edge->get_targets().begin()));
-			auto label = edge->get_label();
-			auto marks = edge->get_marks();
+	return ltl2tgba.run(f);
+}
 
-			std::set<acc_mark> marks_relabelled;
-			for (auto mark : marks) {
-				marks_relabelled.insert(mark_conversion[mark]);
-			}
+// children computing the candidates; those that are still running
+// when build_best_nwa is left (e.g. on an exception) are killed
+struct candidate_jobs {
+	std::vector<child_process> slaa;
+	std::vector<child_process> spot;
 
-			aut->new_edge(source_id, target_id, label, spot::acc_cond::mark_t(marks_relabelled.begin(), marks_relabelled.end()));
+	~candidate_jobs() {
+		for (auto& job : slaa) {
+			kill_child(job);
+		}
+		for (auto& job : spot) {
+			kill_child(job);
 		}
 	}
+};
 
-	aut = spot::scc_filter(aut);
-	aut = try_postprocessing(aut);
+// runs the candidate in a child process that sends back
+// either "A" followed by the automaton in HOA, "E" followed by the error,
+// or "T" followed by the stage cut off by the deadline
+child_process fork_candidate(std::function<spot::twa_graph_ptr()> candidate) {
+	return fork_job([candidate]() {
+		try {
+			std::ostringstream hoa;
+			spot::print_hoa(hoa, candidate());
+			return "A" + hoa.str();
+		} catch (deadline_exceeded& e) {
+			return "T" + e.get_stage();
+		} catch (std::exception& e) {
+			return std::string("E") + e.what();
+		} catch (const char* e) {
+			return std::string("E") + e;
+		} catch (...) {
+			return std::string("EThe computation of a candidate automaton has failed.");
+		}
+	});
+}
 
-	return aut;
+// waits for the candidate computed by fork_candidate and parses it
+// errors of the child are rethrown so that they are handled as in the sequential run
+spot::twa_graph_ptr collect_candidate(child_process& child, spot::bdd_dict_ptr dict) {
+	std::string result;
+	if (!collect_job(child, result) || result.empty()) {
+		throw std::runtime_error("The process computing a candidate automaton has failed.");
+	}
+
+	if (result[0] == 'E') {
+		throw std::runtime_error(result.substr(1));
+	}
+
+	if (result[0] == 'T') {
+		// remember the stage in this process as well
+		deadline_passed(result.c_str() + 1);
+		throw deadline_exceeded(result.substr(1));
+	}
+
+	spot::automaton_stream_parser parser(result.c_str() + 1, "candidate automaton");
+	auto parsed = parser.parse(dict);
+	if (!parsed->aut || parsed->format_errors(std::cerr)) {
+		throw std::runtime_error("Cannot parse the candidate automaton.");
+	}
+
+	return parsed->aut;
 }
 
 std::tuple<spot::twa_graph_ptr, SLAA*, std::string> build_best_nwa(spot::formula f, spot::bdd_dict_ptr dict /* = nullptr */, bool print_alternating /* = false */, bool exit_after_alternating /* = false */) {
@@ -355,7 +582,76 @@ std::tuple<spot::twa_graph_ptr, SLAA*, std::string> build_best_nwa(spot::formula
 	auto orig_f = f;
 	f = simplify_formula(f);
 
-	for (unsigned neg = 0; neg <= (o_try_negation && !exit_after_alternating) && use_ltl3tela_algorithm; ++neg) {
+	// with -P1, the candidates are computed by child processes in advance
+	// and then they are compared in the same order as in the sequential run
+	bool parallel = o_parallel_portfolio && !print_alternating && !exit_after_alternating && !o_mergeable_info;
+	if (parallel && !dict) {
+		// the candidates have to be parsed with a common dictionary
+		dict = spot::make_bdd_dict();
+	}
+
+	candidate_jobs jobs;
+	auto& slaa_jobs = jobs.slaa;
+	auto& spot_jobs = jobs.spot;
+
+	if (parallel) {
+		for (unsigned neg = 0; neg <= o_try_negation && use_ltl3tela_algorithm; ++neg) {
+			auto slaa_f = neg ? simplify_formula(spot::formula::Not(f)) : f;
+			slaa_jobs.push_back(fork_candidate([slaa_f, dict]() {
+				return build_slaa_candidate(slaa_f, dict);
+			}));
+		}
+
+		for (unsigned neg = 0; neg <= o_try_negation && (o_try_ltl2tgba_spotela & 1); ++neg) {
+			auto spot_f = neg ? spot::formula::Not(orig_f) : orig_f;
+			spot_jobs.push_back(fork_candidate([spot_f, dict]() {
+				return build_spot_candidate(spot_f, dict);
+			}));
+		}
+	}
+
+	// with -B, Spot's candidate is computed first and bounds the number of states
+	// of the SLAA candidates; -D1 is excluded as a bigger deterministic automaton may win
+	bool bounded = o_bound_slack > 0 && !parallel && !o_deterministic && !exit_after_alternating
+		&& !o_mergeable_info && use_ltl3tela_algorithm && (o_try_ltl2tgba_spotela & 1);
+
+	spot::twa_graph_ptr nwa_spot = nullptr;
+	std::string stats_spot("spot");
+
+	auto build_spot = [&]() {
+		for (unsigned neg = 0; neg <= o_try_negation; ++neg) {
+			auto spot_f = neg ? spot::formula::Not(orig_f) : orig_f;
+			spot::twa_graph_ptr nwa_spot_temp;
+
+			if (parallel) {
+				nwa_spot_temp = collect_candidate(spot_jobs[neg], dict);
+			} else {
+				nwa_spot_temp = build_spot_candidate(spot_f, dict);
+			}
+
+			if (!neg) {
+				// assign the default Spot automaton
+				nwa_spot = nwa_spot_temp;
+			} else if (spot::is_universal(nwa_spot_temp)) {
+				nwa_spot_temp = spot::dualize(nwa_spot_temp);
+				std::tie(nwa_spot, stats_spot) = compare_automata(nwa_spot, nwa_spot_temp, stats_spot, "spotneg");
+			}
+		}
+
+		if (o_try_ltl2tgba_spotela & 2) {
+			auto nwa_spot_spotela = spotela_simplify(nwa_spot);
+			std::tie(nwa_spot, stats_spot) = compare_automata(nwa_spot, nwa_spot_spotela, stats_spot, stats_spot + "+spotela");
+		}
+	};
+
+	if (bounded) {
+		build_spot();
+	}
+
+	// set if the deadline (-T) has passed during a candidate computation
+	bool cut_off = false;
+
+	for (unsigned neg = 0; neg <= (o_try_negation && !exit_after_alternating) && use_ltl3tela_algorithm && !cut_off; ++neg) {
 		// neg means we try to negate the formula and complement
 		// the resulting automaton, if it's deterministic
 		// we then choose the smaller of the two automata
@@ -363,45 +659,95 @@ std::tuple<spot::twa_graph_ptr, SLAA*, std::string> build_best_nwa(spot::formula
 			f = simplify_formula(spot::formula::Not(f));
 		}
 
+		SLAA* slaa = nullptr;
+
 		try {
-			auto slaa = make_alternating(f, dict);
+			spot::twa_graph_ptr nwa_temp = nullptr;
 
-			if (o_mergeable_info) {
-				// If some mergeable is present, true is already outputed
-				// from the call of is_mergeable or make_alternating_recursive
-				std::cout << false << std::endl;
-				std::exit(0);
-			}
+			if (parallel) {
+				nwa_temp = collect_candidate(slaa_jobs[neg], dict);
+			} else {
+				slaa = make_alternating(f, dict);
+
+				if (o_mergeable_info) {
+					// If some mergeable is present, true is already outputed
+					// from the call of is_mergeable or make_alternating_recursive
+					std::cout << false << std::endl;
+					std::exit(0);
+				}
+
+				slaa->remove_unreachable_states();
+				slaa->remove_unnecessary_marks();
+
+				if (print_alternating && !neg) {
+					slaa_out = slaa;
+				}
 
-			slaa->remove_unreachable_states();
-			slaa->remove_unnecessary_marks();
+				if (!exit_after_alternating) {
+					unsigned state_bound = 0;
+
+					if (bounded) {
+						unsigned best = nwa_spot->num_states();
+						if (nwa && nwa->num_states() < best) {
+							best = nwa->num_states();
+						}
+
+						state_bound = best * o_bound_slack;
+					}
 
-			if (print_alternating && !neg) {
-				slaa_out = slaa;
+					nwa_temp = make_nondeterministic(slaa, state_bound);
+				}
 			}
 
 			if (!exit_after_alternating) {
-				auto nwa_temp = make_nondeterministic(slaa);
 				if (!neg || we_crashed) {
 					// always assign the default value, nothing to compare
 					nwa = nwa_temp;
 				} else if (spot::is_universal(nwa_temp)) { // we are only interested if the automaton is deterministic
 					nwa_temp = spot::dualize(nwa_temp);
-					std::tie(nwa, stats) = compare_automata(nwa, nwa_temp, stats, "neg");
+
+					if (nwa) {
+						std::tie(nwa, stats) = compare_automata(nwa, nwa_temp, stats, "neg");
+					} else {
+						// the candidate for f was pruned by -B
+						nwa = nwa_temp;
+						stats = "neg";
+					}
 				}
 
-				if (o_try_ltl2tgba_spotela & 2) {
+				if ((o_try_ltl2tgba_spotela & 2) && nwa) {
 					auto nwa_spotela = spotela_simplify(nwa);
 					std::tie(nwa, stats) = compare_automata(nwa, nwa_spotela, stats, stats + "+spotela");
 				}
 			}
 
+			// the SLAA is not needed anymore unless it is to be printed
+			if (slaa != slaa_out) {
+				delete slaa;
+			}
+
 			we_crashed = false;
+		} catch (deadline_exceeded& e) {
+			// keep the automaton finished so far (if any)
+			if (slaa != slaa_out) {
+				delete slaa;
+			}
+
+			cut_off = true;
+		} catch (candidate_pruned& e) {
+			// the candidate cannot beat Spot's one
+			if (slaa != slaa_out) {
+				delete slaa;
+			}
 		} catch (std::runtime_error& e) {
 			std::string what(e.what());
 
 			if (what.find("Too many acceptance sets used.") == 0 && !exit_after_alternating) {
 				// nevermind, Spot will do it (hopefully)
+				if (slaa != slaa_out) {
+					delete slaa;
+				}
+
 				we_crashed = true;
 			} else {
 				// rethrow
@@ -417,54 +763,28 @@ std::tuple<spot::twa_graph_ptr, SLAA*, std::string> build_best_nwa(spot::formula
 	}
 
 	if (!exit_after_alternating) {
-		if (o_try_ltl2tgba_spotela & 1) {
-			spot::twa_graph_ptr nwa_spot;
-			std::string stats_spot("spot");
-
-			for (unsigned neg = 0; neg <= o_try_negation; ++neg) {
-				auto spot_f = neg ? spot::formula::Not(orig_f) : orig_f;
-				spot::twa_graph_ptr nwa_spot_temp;
-
-				if (dict) {
-					spot::translator ltl2tgba(dict);
-					if (o_deterministic) {
-						ltl2tgba.set_pref(spot::postprocessor::Deterministic);
-					}
-					ltl2tgba.set_type(spot::postprocessor::Generic);
-					ltl2tgba.set_level(spot::postprocessor::High);
-					nwa_spot_temp = ltl2tgba.run(spot_f);
-				} else {
-					spot::translator ltl2tgba;
-					if (o_deterministic) {
-						ltl2tgba.set_pref(spot::postprocessor::Deterministic);
-					}
-					ltl2tgba.set_type(spot::postprocessor::Generic);
-					ltl2tgba.set_level(spot::postprocessor::High);
-					nwa_spot_temp = ltl2tgba.run(spot_f);
-				}
-				nwa_spot_temp = try_postprocessing(nwa_spot_temp);
-
-				if (!neg) {
-					// assign the default Spot automaton
-					nwa_spot = nwa_spot_temp;
-				} else if (spot::is_universal(nwa_spot_temp)) {
-					nwa_spot_temp = spot::dualize(nwa_spot_temp);
-					std::tie(nwa_spot, stats_spot) = compare_automata(nwa_spot, nwa_spot_temp, stats_spot, "spotneg");
-				}
+		if ((o_try_ltl2tgba_spotela & 1) && (bounded || (!cut_off && !deadline_passed("spot")))) {
+			if (!bounded) {
+				build_spot();
 			}
 
-			if (o_try_ltl2tgba_spotela & 2) {
-				auto nwa_spot_spotela = spotela_simplify(nwa_spot);
-				std::tie(nwa_spot, stats_spot) = compare_automata(nwa_spot, nwa_spot_spotela, stats_spot, stats_spot + "+spotela");
-			}
-
-			if (we_crashed || !use_ltl3tela_algorithm) {
+			if (we_crashed || !use_ltl3tela_algorithm || !nwa) {
 				nwa = nwa_spot;
 				stats = stats_spot;
 			} else {
 				std::tie(nwa, stats) = compare_automata(nwa, nwa_spot, stats, stats_spot);
 			}
 		}
+
+		if (!nwa && !deadline_stage().empty()) {
+			// the deadline has passed before any candidate was finished
+			nwa = build_fallback_candidate(orig_f, dict);
+			stats = "fallback";
+		}
+	}
+
+	if (!deadline_stage().empty()) {
+		stats += " (deadline exceeded in " + deadline_stage() + ")";
 	}
 
 	stats += "\n";
@@ -543,6 +863,10 @@ std::pair<spot::twa_graph_ptr, std::string> build_product_nwa(spot::formula f, s
 }
 
 spot::twa_graph_ptr try_postprocessing(spot::twa_graph_ptr aut) {
+	if (deadline_passed("postprocessing")) {
+		return aut;
+	}
+
 	spot::postprocessor pp;
 	pp.set_type(spot::postprocessor::Generic);
 	if (o_deterministic) {
@@ -19,6 +19,10 @@
 
 #ifndef NONDETERMINISTIC_H
 #define NONDETERMINISTIC_H
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 #include <spot/tl/print.hh>
 #include <spot/twaalgos/cleanacc.hh>
@@ -30,14 +34,73 @@
 #include <spot/twaalgos/isdet.hh>
 #include <spot/twaalgos/translate.hh>
 #include <spot/twaalgos/product.hh>
+#include <spot/parseaut/public.hh>
 #include "automaton.hpp"
 #include "alternating.hpp"
 #include "spotela.hpp"
+#include "parallel.hpp"
 #include "utils.hpp"
+#include "deadline.hpp"
+
+// the hash index of the configurations (sets of SLAA states) of the NA
+// being built; the sets themselves are kept in the state-sets vector
+class config_index {
+	std::vector<std::set<unsigned>>* sets;
+	// maps the hash of a set to its ID
+	std::unordered_multimap<size_t, unsigned> ids;
+public:
+	config_index(std::vector<std::set<unsigned>>* sets);
+
+	static size_t hash(target_range state_set);
+
+	// returns the ID of the set with the hash h or -1U if it is not present
+	unsigned find(target_range state_set, size_t h) const;
+
+	// appends the set with the hash h to the vector
+	void add(target_range state_set, size_t h);
+
+	// returns the number of sets
+	unsigned size() const;
+};
+
+// returns a string representation of a set
+std::string set_to_str(std::set<unsigned> set);
+
+// returns the map { mark => mark } of the siblings of the Fin-marks
+// removed from the NA (the keys of tgba_mark_owners)
+std::map<acc_mark, acc_mark> siblings_of_removed_fin(const SLAA::ac_representation& acr, const std::map<acc_mark, unsigned>& tgba_mark_owners);
+
+// returns the marks of an NA edge with the given label, configuration
+// of the target and marks of the product edge, assigned as LTL2BA does:
+// the removed Fin-marks are replaced by their siblings where appropriate
+mark_set assign_owner_marks(const frozen_slaa& frozen, const std::map<acc_mark, unsigned>& tgba_mark_owners, const std::map<acc_mark, acc_mark>& sibling_of_removed_fin, bdd label, const std::set<unsigned>& target_set, mark_set marks);
+
+// returns the marks the acceptance condition of the NA depends on,
+// i.e. the only ones the NA edges need to keep
+std::set<acc_mark> acceptance_marks(const SLAA::ac_representation& acr, const std::map<acc_mark, unsigned>& tgba_mark_owners);
+
+// returns the acceptance condition of the NA for the representation
+// returned by mark_transformation, where the used marks are renamed
+// by mark_conversion
+spot::acc_cond::acc_code na_acceptance(const SLAA::ac_representation& acr, const std::map<acc_mark, unsigned>& tgba_mark_owners, const std::set<acc_mark>& used_marks, const std::map<acc_mark, acc_mark>& mark_conversion);
+
+// thrown by make_nondeterministic if the automaton gets bigger than the state bound
+class candidate_pruned : public std::runtime_error {
+public:
+	candidate_pruned();
+};
 
 // turns the given SLAA into an equivalent nondeterministic
-// automaton in the Spot's structure
-spot::twa_graph_ptr make_nondeterministic(SLAA* slaa);
+// automaton in the Spot's structure; if state_bound is positive
+// and more states are created, candidate_pruned is thrown
+spot::twa_graph_ptr make_nondeterministic(SLAA* slaa, unsigned state_bound = 0);
+
+// candidates of the portfolio: the SLAA-based translation and Spot's ltl2tgba
+spot::twa_graph_ptr build_slaa_candidate(spot::formula f, spot::bdd_dict_ptr dict);
+spot::twa_graph_ptr build_spot_candidate(spot::formula f, spot::bdd_dict_ptr dict);
+
+// the cheap translation used if the deadline (-T) passes before any candidate is finished
+spot::twa_graph_ptr build_fallback_candidate(spot::formula f, spot::bdd_dict_ptr dict);
 
 // chooses the best nondeterministic automaton for a given formula
 // returns nullptr in the first element of the pair if only alternating automaton is to be produced
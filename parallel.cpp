@@ -0,0 +1,178 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cerrno>
+#include <cstdint>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "parallel.hpp"
+
+bool write_all(int fd, const char* data, size_t len) {
+	while (len > 0) {
+		ssize_t w = write(fd, data, len);
+		if (w < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data += w;
+		len -= w;
+	}
+	return true;
+}
+
+static bool read_all(int fd, char* data, size_t len) {
+	while (len > 0) {
+		ssize_t r = read(fd, data, len);
+		if (r < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		if (r == 0) {
+			// unexpected end of file
+			return false;
+		}
+		data += r;
+		len -= r;
+	}
+	return true;
+}
+
+bool write_message(int fd, const std::string& msg) {
+	uint64_t len = msg.size();
+	return write_all(fd, reinterpret_cast<const char*>(&len), sizeof(len))
+		&& write_all(fd, msg.data(), msg.size());
+}
+
+bool read_message(int fd, std::string& msg) {
+	uint64_t len;
+	if (!read_all(fd, reinterpret_cast<char*>(&len), sizeof(len))) {
+		return false;
+	}
+	msg.resize(len);
+	return read_all(fd, &msg[0], len);
+}
+
+child_process fork_child(std::function<void(int, int)> body, const std::vector<int>& fds_to_close) {
+	int to_child[2];
+	int from_child[2];
+
+	if (pipe(to_child) != 0) {
+		throw std::runtime_error("Cannot create a pipe.");
+	}
+	if (pipe(from_child) != 0) {
+		close(to_child[0]);
+		close(to_child[1]);
+		throw std::runtime_error("Cannot create a pipe.");
+	}
+
+	// do not let the child print what the parent has buffered
+	std::cout.flush();
+	std::cerr.flush();
+	std::fflush(nullptr);
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		for (int fd : { to_child[0], to_child[1], from_child[0], from_child[1] }) {
+			close(fd);
+		}
+		throw std::runtime_error("Cannot fork a new process.");
+	}
+
+	if (pid == 0) {
+		close(to_child[1]);
+		close(from_child[0]);
+		for (int fd : fds_to_close) {
+			close(fd);
+		}
+
+		// an exception must not unwind into the code of the parent
+		try {
+			body(to_child[0], from_child[1]);
+		} catch (...) {
+			std::cout.flush();
+			std::cerr.flush();
+			_exit(1);
+		}
+
+		std::cout.flush();
+		std::cerr.flush();
+		// do not run the destructors of the copied parent state
+		_exit(0);
+	}
+
+	close(to_child[0]);
+	close(from_child[1]);
+
+	return { pid, to_child[1], from_child[0] };
+}
+
+child_process fork_job(std::function<std::string()> job) {
+	auto child = fork_child([&job](int, int out_fd) {
+		write_message(out_fd, job());
+	});
+
+	// the job does not read anything
+	close(child.to_child);
+	child.to_child = -1;
+
+	return child;
+}
+
+bool collect_job(child_process& child, std::string& result) {
+	bool ok = read_message(child.from_child, result);
+	finish_child(child);
+	return ok;
+}
+
+void finish_child(child_process& child) {
+	if (child.to_child >= 0) {
+		close(child.to_child);
+		child.to_child = -1;
+	}
+	if (child.from_child >= 0) {
+		close(child.from_child);
+		child.from_child = -1;
+	}
+
+	if (child.pid <= 0) {
+		// already reaped
+		return;
+	}
+
+	int status;
+	while (waitpid(child.pid, &status, 0) < 0 && errno == EINTR) {
+		// NOP
+	}
+	child.pid = 0;
+}
+
+void kill_child(child_process& child) {
+	if (child.pid > 0) {
+		kill(child.pid, SIGKILL);
+	}
+	finish_child(child);
+}
@@ -0,0 +1,63 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <functional>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+// BuDDy and the o_* options are global, so the parallelism is achieved
+// with forked processes; each of them owns a copy of the BDD package
+
+// writes the whole buffer to the file descriptor
+bool write_all(int fd, const char* data, size_t len);
+
+// writes a length-prefixed message to the file descriptor
+bool write_message(int fd, const std::string& msg);
+
+// reads a length-prefixed message from the file descriptor
+// returns false on end of file or on error
+bool read_message(int fd, std::string& msg);
+
+typedef struct {
+	pid_t pid;
+	int to_child;	// -1 if the child reads nothing
+	int from_child;
+} child_process;
+
+// forks a child that runs body(in_fd, out_fd) and exits
+// fds_to_close are descriptors of other children that the new child must not hold
+child_process fork_child(std::function<void(int, int)> body, const std::vector<int>& fds_to_close = std::vector<int>());
+
+// forks a child computing job(); its result is sent back as a message
+child_process fork_job(std::function<std::string()> job);
+
+// reads the result of fork_job and reaps the child
+// returns false if the child died without sending the result
+bool collect_job(child_process& child, std::string& result);
+
+// closes the descriptors of the child and reaps it
+void finish_child(child_process& child);
+
+// kills the child if it has not been reaped yet
+void kill_child(child_process& child);
+
+#endif
@@ -0,0 +1,246 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "server.hpp"
+
+// reads lines from a file descriptor
+class line_reader {
+	int fd;
+	std::string buffer;
+	bool eof = false;
+
+public:
+	line_reader(int fd) : fd(fd) {}
+
+	bool getline(std::string& line) {
+		size_t pos;
+		while ((pos = buffer.find('\n')) == std::string::npos) {
+			if (eof) {
+				if (buffer.empty()) {
+					return false;
+				}
+				// the last line is not terminated
+				line = buffer;
+				buffer.clear();
+				return true;
+			}
+
+			char chunk[4096];
+			ssize_t r = read(fd, chunk, sizeof(chunk));
+			if (r < 0 && errno == EINTR) {
+				continue;
+			}
+			if (r <= 0) {
+				eof = true;
+			} else {
+				buffer.append(chunk, r);
+			}
+		}
+
+		line = buffer.substr(0, pos);
+		buffer.erase(0, pos + 1);
+		return true;
+	}
+};
+
+// splits the request into arguments; everything after -f is the formula
+static std::vector<std::string> split_request(const std::string& line) {
+	std::vector<std::string> tokens = { "ltl3tela" };
+	std::istringstream in(line);
+	std::string token;
+
+	while (in >> token) {
+		tokens.push_back(token);
+		if (token == "-f") {
+			std::string formula;
+			std::getline(in, formula);
+			auto first = formula.find_first_not_of(" \t");
+			auto last = formula.find_last_not_of(" \t\r");
+			tokens.push_back(first == std::string::npos ? "" : formula.substr(first, last - first + 1));
+			break;
+		}
+	}
+
+	return tokens;
+}
+
+static int handle_translation(const std::string& line, spot::bdd_dict_ptr dict) {
+	auto tokens = split_request(line);
+	std::vector<char*> argv;
+	for (auto& t : tokens) {
+		argv.push_back(&t[0]);
+	}
+
+	auto args = parse_arguments(argv.size(), argv.data());
+
+	// modes of the command line tool are not available in requests;
+	// -m prints its result and exits, which would stop the server
+	if (args.count("f") == 0 || args.count("L") > 0 || args.count("S") > 0 || args.count("h") > 0 || args.count("v") > 0 || args["m"] != "0") {
+		std::cerr << "Invalid request.\n";
+		return 1;
+	}
+
+	spot::formula f;
+	try {
+		f = spot::parse_formula(args["f"]);
+	} catch (spot::parse_error& e) {
+		std::cerr << "The input formula is invalid.\n" << e.what();
+		return 1;
+	}
+
+	set_options(args);
+
+	return translate_and_print(f, args, dict);
+}
+
+static bool write_reply(int fd, int ret, const std::string& out, const std::string& err) {
+	std::string header = std::to_string(ret) + " " + std::to_string(out.size()) + " " + std::to_string(err.size()) + "\n";
+	return write_all(fd, header.data(), header.size())
+		&& write_all(fd, out.data(), out.size())
+		&& write_all(fd, err.data(), err.size());
+}
+
+bool serve_connection(int in_fd, int out_fd, spot::bdd_dict_ptr dict, server_stats& stats) {
+	line_reader reader(in_fd);
+	std::string line;
+
+	while (reader.getline(line)) {
+		auto first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos) {
+			continue;
+		}
+
+		// the commands have to be the whole line, QUITx is a (bad) request
+		auto command = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+		if (command == "QUIT") {
+			return false;
+		}
+
+		if (command == "STATS") {
+			std::ostringstream out;
+			out << "requests: " << stats.requests << '\n'
+				<< "failed: " << stats.failed << '\n'
+				<< "total_ms: " << stats.total_ms << '\n'
+				<< "average_ms: " << (stats.requests ? stats.total_ms / stats.requests : 0.0) << '\n'
+				<< "max_ms: " << stats.max_ms << '\n';
+			if (!write_reply(out_fd, 0, out.str(), "")) {
+				return true;
+			}
+			continue;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		std::string out;
+		std::string err;
+		int ret = run_captured([&]() {
+			return handle_translation(line, dict);
+		}, out, err);
+
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		++stats.requests;
+		if (ret != 0) {
+			++stats.failed;
+		}
+		stats.total_ms += ms;
+		stats.max_ms = std::max(stats.max_ms, ms);
+
+		if (!write_reply(out_fd, ret, out, err)) {
+			// the client has gone away
+			return true;
+		}
+	}
+
+	return true;
+}
+
+int run_server(std::string path, spot::bdd_dict_ptr dict) {
+	// a client closing the connection must not kill the server
+	signal(SIGPIPE, SIG_IGN);
+
+	server_stats stats = { 0, 0, 0.0, 0.0 };
+
+	if (path == "-") {
+		serve_connection(STDIN_FILENO, STDOUT_FILENO, dict, stats);
+		return 0;
+	}
+
+	sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path)) {
+		std::cerr << "The socket path is too long.\n";
+		return 2;
+	}
+	std::strcpy(addr.sun_path, path.c_str());
+
+	int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0) {
+		std::cerr << "Cannot create a socket.\n";
+		return 2;
+	}
+
+	// remove a stale socket left by a previous server, but nothing else
+	struct stat st;
+	if (lstat(path.c_str(), &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			std::cerr << "Cannot listen on " << path << ": the file exists and it is not a socket.\n";
+			close(sock);
+			return 2;
+		}
+
+		unlink(path.c_str());
+	}
+
+	if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(sock, 16) != 0) {
+		std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << '\n';
+		close(sock);
+		return 2;
+	}
+
+	// the BDD package is not thread-safe, so the connections are served one by one
+	bool running = true;
+	while (running) {
+		int conn = accept(sock, nullptr, nullptr);
+		if (conn < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			std::cerr << "Cannot accept a connection: " << std::strerror(errno) << '\n';
+			break;
+		}
+
+		running = serve_connection(conn, conn, dict, stats);
+		close(conn);
+	}
+
+	close(sock);
+	unlink(path.c_str());
+
+	return 0;
+}
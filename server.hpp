@@ -0,0 +1,52 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SERVER_H
+#define SERVER_H
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "utils.hpp"
+
+// The server reads requests line by line. A request is either
+//   <flags> -f <formula>   translate the formula (the formula is the rest of the line)
+//   STATS                  print the request and latency counters
+//   QUIT                   stop the server
+// Each reply starts with the line "<exit code> <m> <n>" followed by
+// m bytes of the translator's STDOUT and n bytes of its STDERR.
+
+typedef struct {
+	unsigned long requests;
+	unsigned long failed;
+	double total_ms;
+	double max_ms;
+} server_stats;
+
+// serves requests from in_fd and writes replies to out_fd until QUIT or end of input
+// returns false if QUIT was received
+bool serve_connection(int in_fd, int out_fd, spot::bdd_dict_ptr dict, server_stats& stats);
+
+// serves requests on the Unix domain socket at the given path,
+// or on STDIN and STDOUT if the path is "-"
+int run_server(std::string path, spot::bdd_dict_ptr dict);
+
+#endif
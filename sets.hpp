@@ -0,0 +1,313 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef SETS_H
+#define SETS_H
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include <spot/twa/acc.hh>
+
+// compact sets used by edges; both offer the part of the std::set
+// interface used in LTL3TELA, so they can be used as drop-in replacements
+
+// returns a 64-bit signature of a set of states: the bit x mod 64 is set
+// for each state x; if A ⊆ B then the bits of A are a subset of those of B
+template<typename It> uint64_t states_signature(It first, It last) {
+	uint64_t signature = 0;
+	for (; first != last; ++first) {
+		signature |= uint64_t(1) << (*first % 64);
+	}
+
+	return signature;
+}
+
+// a set of states kept as a sorted vector; edges have mostly up to 3 targets
+class target_set {
+	std::vector<unsigned> elems;
+
+	// the signature of elems, used to reject most non-subsets in subset_of
+	uint64_t signature = 0;
+public:
+	typedef std::vector<unsigned>::const_iterator const_iterator;
+	typedef const_iterator iterator;
+	typedef unsigned value_type;
+
+	target_set() {
+	}
+
+	target_set(std::initializer_list<unsigned> l) {
+		insert(l.begin(), l.end());
+	}
+
+	target_set(const std::set<unsigned>& s) : elems(s.begin(), s.end()), signature(states_signature(s.begin(), s.end())) {
+	}
+
+	operator std::set<unsigned>() const {
+		return std::set<unsigned>(elems.begin(), elems.end());
+	}
+
+	const_iterator begin() const {
+		return elems.begin();
+	}
+
+	const_iterator end() const {
+		return elems.end();
+	}
+
+	unsigned size() const {
+		return elems.size();
+	}
+
+	bool empty() const {
+		return elems.empty();
+	}
+
+	const_iterator find(unsigned x) const {
+		auto it = std::lower_bound(elems.begin(), elems.end(), x);
+		return (it != elems.end() && *it == x) ? it : elems.end();
+	}
+
+	unsigned count(unsigned x) const {
+		return std::binary_search(elems.begin(), elems.end(), x);
+	}
+
+	void insert(unsigned x) {
+		auto it = std::lower_bound(elems.begin(), elems.end(), x);
+		if (it == elems.end() || *it != x) {
+			elems.insert(it, x);
+			signature |= uint64_t(1) << (x % 64);
+		}
+	}
+
+	template<typename It> void insert(It first, It last) {
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+	void insert(const target_set& other) {
+		std::vector<unsigned> result;
+		result.reserve(elems.size() + other.elems.size());
+		std::set_union(elems.begin(), elems.end(), other.elems.begin(), other.elems.end(), std::back_inserter(result));
+		elems.swap(result);
+		signature |= other.signature;
+	}
+
+	void erase(unsigned x) {
+		auto it = std::lower_bound(elems.begin(), elems.end(), x);
+		if (it != elems.end() && *it == x) {
+			erase(it);
+		}
+	}
+
+	const_iterator erase(const_iterator it) {
+		auto next = elems.erase(it);
+		// other states may share the bit of the removed one
+		signature = states_signature(elems.begin(), elems.end());
+		return next;
+	}
+
+	void clear() {
+		elems.clear();
+		signature = 0;
+	}
+
+	uint64_t get_signature() const {
+		return signature;
+	}
+
+	// returns true if this set is a subset of other
+	bool subset_of(const target_set& other) const {
+		if ((signature & ~other.signature) != 0) {
+			return false;
+		}
+
+		return std::includes(other.elems.begin(), other.elems.end(), elems.begin(), elems.end());
+	}
+
+	bool operator==(const target_set& other) const {
+		return elems == other.elems;
+	}
+
+	bool operator!=(const target_set& other) const {
+		return elems != other.elems;
+	}
+
+	bool operator<(const target_set& other) const {
+		return elems < other.elems;
+	}
+};
+
+// a set of acceptance marks kept as a bit vector of Spot;
+// it is bounded by the number of acceptance sets Spot supports
+class mark_set {
+	spot::acc_cond::mark_t bits;
+public:
+	explicit mark_set(spot::acc_cond::mark_t m) : bits(m) {
+	}
+
+	// iterates over the marks in the increasing order
+	class const_iterator {
+		// the marks not visited yet and the smallest of them
+		spot::acc_cond::mark_t rest;
+		unsigned current;
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef unsigned value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const unsigned* pointer;
+		typedef const unsigned& reference;
+
+		const_iterator(spot::acc_cond::mark_t m) : rest(m), current(m.min_set() - 1) {
+		}
+
+		const unsigned& operator*() const {
+			return current;
+		}
+
+		const_iterator& operator++() {
+			rest.clear(current);
+			current = rest.min_set() - 1;
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			auto old = *this;
+			++(*this);
+			return old;
+		}
+
+		bool operator==(const const_iterator& other) const {
+			return rest == other.rest;
+		}
+
+		bool operator!=(const const_iterator& other) const {
+			return rest != other.rest;
+		}
+	};
+
+	typedef const_iterator iterator;
+	typedef unsigned value_type;
+
+	mark_set() : bits({}) {
+	}
+
+	mark_set(std::initializer_list<unsigned> l) : bits({}) {
+		insert(l.begin(), l.end());
+	}
+
+	mark_set(const std::set<unsigned>& s) : bits({}) {
+		insert(s.begin(), s.end());
+	}
+
+	operator std::set<unsigned>() const {
+		return std::set<unsigned>(begin(), end());
+	}
+
+	// the marks as Spot's mark_t
+	spot::acc_cond::mark_t as_mark_t() const {
+		return bits;
+	}
+
+	const_iterator begin() const {
+		return const_iterator(bits);
+	}
+
+	const_iterator end() const {
+		return const_iterator(spot::acc_cond::mark_t({}));
+	}
+
+	unsigned size() const {
+		return bits.count();
+	}
+
+	bool empty() const {
+		return !bits;
+	}
+
+	unsigned count(unsigned x) const {
+		return x < spot::acc_cond::mark_t::max_accsets() && bits.has(x);
+	}
+
+	void insert(unsigned x) {
+		if (x >= spot::acc_cond::mark_t::max_accsets()) {
+			// the same error as Spot reports, handled by build_best_nwa
+			throw std::runtime_error("Too many acceptance sets used.");
+		}
+
+		bits.set(x);
+	}
+
+	template<typename It> void insert(It first, It last) {
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+	void insert(const mark_set& other) {
+		bits |= other.bits;
+	}
+
+	void erase(unsigned x) {
+		if (count(x)) {
+			bits.clear(x);
+		}
+	}
+
+	void clear() {
+		bits = spot::acc_cond::mark_t({});
+	}
+
+	// returns true if this set is a subset of other
+	bool subset_of(const mark_set& other) const {
+		return bits.subset(other.bits);
+	}
+
+	mark_set operator&(const mark_set& other) const {
+		return mark_set(bits & other.bits);
+	}
+
+	mark_set operator|(const mark_set& other) const {
+		return mark_set(bits | other.bits);
+	}
+
+	mark_set operator-(const mark_set& other) const {
+		return mark_set(bits - other.bits);
+	}
+
+	bool operator==(const mark_set& other) const {
+		return bits == other.bits;
+	}
+
+	bool operator!=(const mark_set& other) const {
+		return bits != other.bits;
+	}
+
+	bool operator<(const mark_set& other) const {
+		return bits < other.bits;
+	}
+};
+
+#endif
@@ -193,7 +193,8 @@ spot::twa_graph_ptr spotela_simplify(spot::twa_graph_ptr aut) {
 	}
 
 	auto aut2 = simplify_one_scc(aut);
-	while (aut2->num_states() < aut->num_states()) {
+	// every step produces an equivalent automaton, so we may stop at any time
+	while (aut2->num_states() < aut->num_states() && !deadline_passed("spotela")) {
 		aut = aut2;
 		aut2 = simplify_one_scc(aut);
 	}
@@ -31,6 +31,7 @@
 #include <spot/twaalgos/postproc.hh>
 #include <spot/twaalgos/sccinfo.hh>
 #include "utils.hpp"
+#include "deadline.hpp"
 
 typedef spot::twa_graph::graph_t::edge_storage_t edge_t;
 
@@ -0,0 +1,236 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream.hpp"
+
+// the States: header can be back-patched only in a regular file
+// that is not opened for appending (with >>, writes go to its end)
+static bool stdout_patchable() {
+	struct stat st;
+	if (fstat(STDOUT_FILENO, &st) != 0 || !S_ISREG(st.st_mode)) {
+		return false;
+	}
+
+	int flags = fcntl(STDOUT_FILENO, F_GETFL);
+	return flags != -1 && (flags & O_APPEND) == 0;
+}
+
+// a 64-bit hash of a configuration
+static uint64_t config_hash(target_range state_set) {
+	uint64_t h = state_set.size();
+	for (auto state : state_set) {
+		// the splitmix64 finalizer
+		h += state + 0x9e3779b97f4a7c15ULL;
+		h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+		h ^= h >> 31;
+	}
+
+	return h;
+}
+
+void print_nondeterministic_hoaf(SLAA* slaa) {
+	// a map { mark => SLAA state } of Fin-marks removed from NA
+	std::map<acc_mark, unsigned> tgba_mark_owners;
+	auto acr = slaa->mark_transformation(tgba_mark_owners);
+	auto sibling_of_removed_fin = siblings_of_removed_fin(acr, tgba_mark_owners);
+
+	// the acceptance condition has to be printed before the states,
+	// so the marks it does not use are removed in advance
+	auto used_marks = acceptance_marks(acr, tgba_mark_owners);
+	if (used_marks.size() > spot::acc_cond::mark_t::max_accsets()) {
+		throw std::runtime_error("Too many acceptance sets used.");
+	}
+
+	std::map<acc_mark, acc_mark> mark_conversion;
+	acc_mark mark_counter = 0;
+	for (auto old_mark : used_marks) {
+		mark_conversion[old_mark] = mark_counter;
+		++mark_counter;
+	}
+
+	slaa->share_edges();
+	const auto frozen = slaa->freeze();
+	product_trie products;
+
+	// the IDs of the configurations by their hashes; the configurations
+	// in the queue get IDs in the order of discovery, i.e. of printing
+	std::unordered_map<uint64_t, unsigned> ids;
+	std::queue<std::vector<unsigned>> q;
+
+	auto get_id = [&](target_range state_set) {
+		auto inserted = ids.emplace(config_hash(state_set), ids.size());
+		if (inserted.second) {
+			q.emplace(state_set.begin(), state_set.end());
+		}
+
+		return inserted.first->second;
+	};
+
+	spot::tl_simplifier simp;
+
+	std::cout << "HOA: v1\n";
+	std::cout << "tool: \"LTL3TELA\"\n";
+	std::cout << "name: \"" << spot::unabbreviate(simp.simplify(slaa->get_input_formula()), "WM") << "\"\n";
+
+	// reserve the space for the number of states
+	std::streampos states_pos = -1;
+	if (stdout_patchable()) {
+		states_pos = std::cout.tellp();
+	}
+
+	if (states_pos != -1) {
+		std::cout << "States: " << std::string(10, ' ') << '\n';
+	}
+
+	// fills in the number of states discovered so far
+	auto patch_states = [&]() {
+		if (states_pos == -1) {
+			return;
+		}
+
+		auto end_pos = std::cout.tellp();
+		auto states_count = std::to_string(ids.size());
+		states_count.resize(10, ' ');
+
+		std::cout.seekp(states_pos);
+		std::cout << "States: " << states_count;
+		std::cout.seekp(end_pos);
+	};
+
+	// more initial configurations are printed as more initial states
+	std::set<unsigned> init_ids;
+	for (auto& init_set : slaa->get_init_sets()) {
+		std::vector<unsigned> init_states(init_set.begin(), init_set.end());
+		init_ids.insert(get_id(target_range(init_states.data(), init_states.data() + init_states.size())));
+	}
+
+	for (auto init_id : init_ids) {
+		std::cout << "Start: " << init_id << '\n';
+	}
+
+	// the dictionary may be shared with other automata, so the BDD
+	// variables are not the AP indices in general
+	auto ap_index = hoaf_ap_index(slaa->spot_aut);
+
+	auto aps = slaa->spot_aut->ap();
+	std::cout << "AP: " << aps.size();
+	for (auto& ap : aps) {
+		std::cout << " \"" << ap << '"';
+	}
+	std::cout << '\n';
+
+	std::cout << "Acceptance: " << used_marks.size() << ' ';
+	na_acceptance(acr, tgba_mark_owners, used_marks, mark_conversion).to_text(std::cout);
+	std::cout << "\nproperties: trans-labels explicit-labels trans-acc\n";
+
+	std::cout << "--BODY--\n";
+	// the product may be cut off by the deadline (-T) after some states
+	// are printed; the automaton is then aborted as HOA allows
+	try {
+		for (unsigned source_id = 0; !q.empty(); ++source_id) {
+			std::set<unsigned> source_set(q.front().begin(), q.front().end());
+			q.pop();
+
+			// edges with the same target and marks are merged
+			std::map<std::pair<unsigned, spot::acc_cond::mark_t>, bdd> edges;
+
+			if (source_set.empty()) {
+				// if the state is ∅, add a true loop
+				edges.emplace(std::make_pair(source_id, spot::acc_cond::mark_t()), bdd_true());
+			} else {
+				frozen.product(source_set, products, [&](bdd label, target_range targets, spot::acc_cond::mark_t marks) {
+					unsigned target_id = get_id(targets);
+
+					mark_set edge_marks(marks);
+					if (!tgba_mark_owners.empty()) {
+						std::set<unsigned> target_set(targets.begin(), targets.end());
+						edge_marks = assign_owner_marks(frozen, tgba_mark_owners, sibling_of_removed_fin, label, target_set, edge_marks);
+					}
+
+					spot::acc_cond::mark_t marks_relabelled = {};
+					for (auto mark : edge_marks) {
+						auto it = mark_conversion.find(mark);
+						if (it != mark_conversion.end()) {
+							marks_relabelled.set(it->second);
+						}
+					}
+
+					auto inserted = edges.emplace(std::make_pair(target_id, marks_relabelled), label);
+					if (!inserted.second) {
+						inserted.first->second |= label;
+					}
+				});
+			}
+
+			std::cout << "State: " << source_id << " \"" << set_to_str(source_set) << "\"\n";
+			for (auto& edge : edges) {
+				std::cout << "  [";
+				print_label_hoaf(edge.second, ap_index);
+				std::cout << "] " << edge.first.first;
+
+				auto marks = edge.first.second.sets();
+				if (!marks.empty()) {
+					std::cout << " {";
+					bool mark_printed = false;
+
+					for (auto mark : marks) {
+						if (mark_printed) {
+							std::cout << ' ';
+						}
+						std::cout << mark;
+						mark_printed = true;
+					}
+
+					std::cout << '}';
+				}
+
+				std::cout << '\n';
+			}
+		}
+	} catch (...) {
+		std::cout << "--ABORT--\n";
+		patch_states();
+		throw;
+	}
+
+	std::cout << "--END--\n";
+	patch_states();
+}
+
+void stream_formula(spot::formula f, spot::bdd_dict_ptr dict) {
+	start_deadline();
+	reset_edges_peak();
+	reset_domination_stats();
+	reset_product_stats();
+
+	auto slaa = make_alternating(simplify_formula(f), dict);
+
+	slaa->remove_unreachable_states();
+	slaa->remove_unnecessary_marks();
+
+	try {
+		print_nondeterministic_hoaf(slaa);
+	} catch (...) {
+		delete slaa;
+		throw;
+	}
+
+	delete slaa;
+}
@@ -0,0 +1,42 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STREAM_H
+#define STREAM_H
+#include <cstdint>
+#include <queue>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "nondeterministic.hpp"
+
+// prints the NA of the given SLAA to STDOUT in HOA format (-o stream);
+// each state is printed as soon as its successors are computed, so only
+// the configurations waiting in the queue and 64-bit hashes of the others
+// are kept in memory (two configurations with equal hashes would be merged)
+// no postprocessing, domination or state merging is applied; the States:
+// header is back-patched at the end if STDOUT is a regular file not opened
+// for appending, else omitted; if the product is cut off by the deadline,
+// the automaton ends with --ABORT-- and the exception is rethrown
+void print_nondeterministic_hoaf(SLAA* slaa);
+
+// translates the formula to SLAA and prints its NA as above
+void stream_formula(spot::formula f, spot::bdd_dict_ptr dict);
+
+#endif
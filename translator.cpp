@@ -0,0 +1,195 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spot/twaalgos/relabel.hh>
+#include "translator.hpp"
+#include "cache.hpp"
+
+std::tuple<spot::twa_graph_ptr, SLAA*, std::string> translate_formula(spot::formula f, spot::bdd_dict_ptr dict, bool print_alternating, bool exit_after_alternating) {
+	spot::twa_graph_ptr nwa = nullptr;
+	SLAA* slaa = nullptr;
+	std::string stats("");
+
+	// the cache holds the final automaton only, the SLAA has to be built;
+	// the same holds for relabeling, SLAA would be printed with the new names
+	bool only_nwa = !print_alternating && !exit_after_alternating && !o_mergeable_info;
+	bool use_cache = !o_cache_dir.empty() && only_nwa;
+	bool relabel = o_relabel_aps && only_nwa;
+	spot::relabeling_map relabeling;
+	std::string key;
+
+	start_deadline();
+	reset_edges_peak();
+	reset_domination_stats();
+	reset_product_stats();
+
+	if (relabel) {
+		f = relabel_canonically(f, relabeling);
+	}
+
+	if (use_cache) {
+		key = cache_key(simplify_formula(f));
+		std::tie(nwa, stats) = cache_lookup(key, dict);
+	}
+
+	if (!nwa) {
+		std::tie(nwa, slaa, stats) = build_best_nwa(f, dict, print_alternating, exit_after_alternating);
+
+		f = simplify_formula(f);
+
+		if (o_ltl_split && !deadline_passed("product")) {
+			spot::twa_graph_ptr nwa_prod;
+			std::string stats_prod;
+
+			try {
+				std::tie(nwa_prod, stats_prod) = build_product_nwa(f, dict);
+				std::tie(nwa, stats) = compare_automata(nwa, nwa_prod, stats, stats_prod);
+			} catch (deadline_exceeded&) {
+				// keep the automaton of build_best_nwa
+			}
+		}
+
+		// an automaton cut off by the deadline may be worse than the one found without it
+		if (use_cache && nwa && deadline_stage().empty()) {
+			cache_store(key, nwa, stats);
+		}
+	}
+
+	if (relabel && nwa) {
+		restore_labels(nwa, relabeling);
+	}
+
+	return std::make_tuple(nwa, slaa, stats);
+}
+
+// replaces the atomic propositions of f according to m
+static spot::formula relabel_aps(spot::formula f, const spot::relabeling_map& m) {
+	if (f.is(spot::op::ap)) {
+		auto it = m.find(f);
+		return it == m.end() ? f : it->second;
+	}
+
+	return f.map([&m](spot::formula g) {
+		return relabel_aps(g, m);
+	});
+}
+
+spot::formula relabel_canonically(spot::formula f, spot::relabeling_map& back) {
+	spot::relabeling_map forth;
+	structural_order order;
+
+	// the APs are numbered by their first occurrence in the structural order
+	std::function<void(spot::formula)> visit = [&](spot::formula g) {
+		if (g.is(spot::op::ap)) {
+			if (forth.count(g) == 0) {
+				auto p = spot::formula::ap("p" + std::to_string(forth.size()));
+				forth[g] = p;
+				back[p] = g;
+			}
+			return;
+		}
+
+		for (auto& h : order.operands(g)) {
+			visit(h);
+		}
+	};
+	visit(f);
+
+	return relabel_aps(f, forth);
+}
+
+void restore_labels(spot::twa_graph_ptr aut, const spot::relabeling_map& back) {
+	// relabel_here registers every AP of the map, keep only those used by aut
+	spot::relabeling_map used;
+	for (auto& ap : aut->ap()) {
+		auto it = back.find(ap);
+		if (it != back.end()) {
+			used.insert(*it);
+		}
+	}
+
+	spot::relabel_here(aut, &used);
+
+	auto name = aut->get_named_prop<std::string>("automaton-name");
+	if (name) {
+		try {
+			auto f = relabel_aps(spot::parse_formula(*name), back);
+			aut->set_named_prop("automaton-name", new std::string(spot::str_psl(f)));
+		} catch (spot::parse_error&) {
+			// keep the name
+		}
+	}
+}
+
+options_guard::options_guard(const translator_options& o) : saved(get_options()) {
+	set_options(o);
+}
+
+options_guard::~options_guard() {
+	set_options(saved);
+}
+
+Translator::Translator(spot::bdd_dict_ptr dict) : Translator(translator_options(), dict) {
+}
+
+Translator::Translator(const translator_options& opts, spot::bdd_dict_ptr dict) : opts(opts) {
+	this->dict = dict ? dict : spot::make_bdd_dict();
+}
+
+translator_options& Translator::options() {
+	return opts;
+}
+
+spot::bdd_dict_ptr Translator::get_dict() const {
+	return dict;
+}
+
+spot::twa_graph_ptr Translator::translate(spot::formula f, std::string* stats) {
+	options_guard guard(opts);
+
+	auto result = translate_formula(f, dict);
+
+	if (stats) {
+		*stats = std::get<2>(result);
+	}
+
+	return std::get<0>(result);
+}
+
+spot::twa_graph_ptr Translator::translate(const std::string& f, std::string* stats) {
+	return translate(spot::parse_formula(f), stats);
+}
+
+SLAA* Translator::make_slaa(spot::formula f) {
+	options_guard guard(opts);
+	start_deadline();
+
+	auto slaa = make_alternating(simplify_formula(f), dict);
+	slaa->remove_unreachable_states();
+	slaa->remove_unnecessary_marks();
+
+	return slaa;
+}
+
+spot::twa_graph_ptr Translator::make_na(SLAA* slaa) {
+	options_guard guard(opts);
+	start_deadline();
+
+	return make_nondeterministic(slaa);
+}
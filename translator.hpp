@@ -0,0 +1,88 @@
+/*
+    Copyright (c) 2019 Juraj Major
+
+    This file is part of LTL3TELA.
+
+    LTL3TELA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LTL3TELA is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LTL3TELA.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TRANSLATOR_H
+#define TRANSLATOR_H
+#include <functional>
+#include <map>
+#include <string>
+#include <tuple>
+#include <spot/tl/formula.hh>
+#include <spot/tl/relabel.hh>
+#include <spot/twa/twagraph.hh>
+#include "utils.hpp"
+#include "automaton.hpp"
+#include "alternating.hpp"
+#include "nondeterministic.hpp"
+#include "deadline.hpp"
+
+// translates the formula with the current o_* options:
+// build_best_nwa followed by the product construction if -l1 is set
+std::tuple<spot::twa_graph_ptr, SLAA*, std::string> translate_formula(spot::formula f, spot::bdd_dict_ptr dict, bool print_alternating = false, bool exit_after_alternating = false);
+
+// renames the atomic propositions of f to p0, p1, ... in the order of their first
+// occurrence, with the operands of commutative operators sorted structurally
+// (not by Spot's creation order); back receives the map from the new names
+// to the original ones
+spot::formula relabel_canonically(spot::formula f, spot::relabeling_map& back);
+
+// renames the atomic propositions of aut (and its name) according to back
+void restore_labels(spot::twa_graph_ptr aut, const spot::relabeling_map& back);
+
+// sets the o_* options for its lifetime and restores the previous ones afterwards
+class options_guard {
+	translator_options saved;
+public:
+	options_guard(const translator_options& o);
+	~options_guard();
+};
+
+// The library interface of LTL3TELA.
+// Each Translator has its own options; they are installed to the o_* options
+// for the duration of each call. As BuDDy is not thread-safe, neither are the calls.
+// The BDD package has to be initialized by the caller (e.g. by bdd_init).
+class Translator {
+protected:
+	translator_options opts;
+	spot::bdd_dict_ptr dict;
+
+public:
+	Translator(spot::bdd_dict_ptr dict = nullptr);
+	Translator(const translator_options& opts, spot::bdd_dict_ptr dict = nullptr);
+
+	// returns the options that are used by the subsequent calls
+	translator_options& options();
+
+	// returns the dictionary shared by the produced automata
+	spot::bdd_dict_ptr get_dict() const;
+
+	// translates the formula to the best automaton found
+	// if stats is not nullptr, it receives the statistics printed with -x1
+	spot::twa_graph_ptr translate(spot::formula f, std::string* stats = nullptr);
+	spot::twa_graph_ptr translate(const std::string& f, std::string* stats = nullptr);
+
+	// the first stage: builds an SLAA for the simplified formula
+	// the caller is responsible for deleting it
+	SLAA* make_slaa(spot::formula f);
+
+	// the second stage: dealternates the SLAA
+	spot::twa_graph_ptr make_na(SLAA* slaa);
+};
+
+#endif
@@ -18,8 +18,84 @@
 */
 
 #include "utils.hpp"
+#include "deadline.hpp"
+
+// the options of the running translation; the defaults are given only
+// by the member initializers of translator_options
+static const translator_options default_options;
+
+unsigned o_try_ltl2tgba_spotela = default_options.try_ltl2tgba_spotela;	// -b
+unsigned o_slaa_trans_red = default_options.slaa_trans_red;	// -c
+bool o_single_init_state = default_options.single_init_state;	// -i
+unsigned o_slaa_determ = default_options.slaa_determ;	// -d
+unsigned o_eq_level = default_options.eq_level;	// -e
+bool o_ltl_split = default_options.ltl_split;	// -l
+unsigned o_mergeable_info = default_options.mergeable_info;	// -m
+bool o_try_negation = default_options.try_negation;	// -n
+bool o_simplify_formula = default_options.simplify_formula;	// -s
+bool o_ac_filter_fin = default_options.ac_filter_fin;	// -t
+unsigned o_debug = default_options.debug;	// -x
+
+bool o_antichain = default_options.antichain;	// -A
+unsigned o_bound_slack = default_options.bound_slack;	// -B
+bool o_deterministic = default_options.deterministic;	// -D
+
+unsigned o_u_merge_level = default_options.u_merge_level;	// -F
+unsigned o_g_merge_level = default_options.g_merge_level;	// -G
+bool o_disj_merging = default_options.disj_merging;	// -O
+bool o_parallel_portfolio = default_options.parallel_portfolio;	// -P
+bool o_relabel_aps = default_options.relabel_aps;	// -R
+bool o_x_single_succ = default_options.x_single_succ;	// -X
+
+unsigned o_deadline = default_options.deadline;	// -T
+
+std::string o_cache_dir = default_options.cache_dir;	// -C
+unsigned o_cache_size = default_options.cache_size;	// -K
+
+std::vector<spot::formula> structural_order::operands(spot::formula f) {
+	std::vector<spot::formula> result(f.begin(), f.end());
+
+	if (f.is(spot::op::And, spot::op::Or) || f.is(spot::op::Xor, spot::op::Equiv)
+		|| f.is(spot::op::AndRat, spot::op::OrRat, spot::op::AndNLM)) {
+		std::stable_sort(result.begin(), result.end(), [&](spot::formula g, spot::formula h) {
+			return get_key(g) < get_key(h);
+		});
+	}
+
+	return result;
+}
+
+const std::string& structural_order::str(spot::formula f) {
+	return get_key(f).second;
+}
+
+const structural_order::structure_key& structural_order::get_key(spot::formula f) {
+	auto it = keys.find(f);
+	if (it != keys.end()) {
+		return it->second;
+	}
+
+	structure_key key;
+	if (f.is(spot::op::ap)) {
+		key = std::make_pair("ap", "\"" + f.ap_name() + "\"");
+	} else {
+		key.first = key.second = f.kindstr() + "(";
+		for (auto& g : operands(f)) {
+			const auto& g_key = get_key(g);
+			key.first += g_key.first + ",";
+			key.second += g_key.second + ",";
+		}
+		key.first += ")";
+		key.second += ")";
+	}
+
+	// the references to the elements stay valid when the map grows
+	return keys[f] = key;
+}
 
 std::set<std::set<spot::formula>> f_bar(spot::formula f) {
+	check_deadline("f_bar");
+
 	std::set<std::set<spot::formula> > r;
 	if (f.is(spot::op::And)) {
 		std::set<std::set<spot::formula> > r1 = f_bar(f[0]);
@@ -64,6 +140,7 @@ std::map<std::string, std::string> parse_arguments(int argc, char * argv[]) {
 	// the first value in a vector is the default one
 	std::map<std::string, std::vector<std::string>> allowed_values = {
 		{"a", { "0", "2", "3" }},
+		{"A", { "0", "1" }},
 		{"b", { "3", "2", "1", "0" }},
 		{"c", { "3", "0", "1", "2" }},
 		{"d", { "2", "0", "1" }},
@@ -75,15 +152,21 @@ std::map<std::string, std::string> parse_arguments(int argc, char * argv[]) {
 		{"l", { "1", "0" }},
 		{"m", { "0", "1", "2" }},
 		{"n", { "1", "0" }},
-		{"o", { "hoa", "dot" }},
+		{"o", { "hoa", "dot", "stream" }},
 		{"O", { "0", "1" }},
+		{"P", { "0", "1" }},
 		{"p", { "2", "1", "3" }},
+		{"R", { "0", "1" }},
 		{"s", { "1", "0" }},
 		{"t", { "1", "0" }},
-		{"x", { "0", "1", "2", "3" }},
+		{"x", { "0", "1", "2", "3", "4", "5", "6", "7" }},
 		{"X", { "0", "1" }},
 	};
 	std::set<std::string> args_without_values = { "h", "v" };
+	// arguments whose values are not checked against allowed_values
+	std::set<std::string> args_with_any_value = { "C", "f", "L", "S" };
+	// arguments whose values are positive integers
+	std::set<std::string> args_with_number = { "B", "j", "K", "T" };
 
 	for (int i = 1; i < argc; ++i) {
 		if (last_arg_name.empty()) {
@@ -123,11 +206,28 @@ std::map<std::string, std::string> parse_arguments(int argc, char * argv[]) {
 	for (auto& r : result) {
 		if (allowed_values.count(r.first) == 0
 			&& args_without_values.find(r.first) == std::end(args_without_values)
-			&& r.first != "f") {
+			&& args_with_any_value.find(r.first) == std::end(args_with_any_value)
+			&& args_with_number.find(r.first) == std::end(args_with_number)) {
 			// flag not supported
 			result.clear();
 			break;
 		}
+
+		if (args_with_number.count(r.first) > 0) {
+			if (r.second.empty() || r.second.find_first_not_of("0123456789") != std::string::npos) {
+				// not a positive number
+				result.clear();
+				break;
+			}
+
+			errno = 0;
+			unsigned long value = std::strtoul(r.second.c_str(), nullptr, 10);
+			if (errno == ERANGE || value == 0 || value > UINT_MAX) {
+				// zero or too big for unsigned
+				result.clear();
+				break;
+			}
+		}
 	}
 
 	// simulation of LTL2BA means default values -d0 -X0 -n0
@@ -168,9 +268,139 @@ std::map<std::string, std::string> parse_arguments(int argc, char * argv[]) {
 		}
 	}
 
+	// -m exits after the first formula, so it cannot be used for a list
+	if (result.count("L") > 0 && result["m"] != "0") {
+		result.clear();
+	}
+
 	return result;
 }
 
+translator_options options_from_arguments(std::map<std::string, std::string>& args) {
+	translator_options o;
+
+	o.try_ltl2tgba_spotela = std::stoi(args["b"]);
+	o.slaa_trans_red = std::stoi(args["c"]);
+	o.single_init_state = std::stoi(args["i"]);
+	o.slaa_determ = std::stoi(args["d"]);
+	o.eq_level = std::stoi(args["e"]);
+	o.ltl_split = std::stoi(args["l"]);
+	o.mergeable_info = std::stoi(args["m"]);
+	o.try_negation = std::stoi(args["n"]);
+	o.simplify_formula = std::stoi(args["s"]);
+	o.ac_filter_fin = std::stoi(args["t"]);
+	o.debug = std::stoi(args["x"]);
+
+	o.antichain = std::stoi(args["A"]);
+	o.deterministic = std::stoi(args["D"]);
+
+	if (args.count("B") > 0) {
+		o.bound_slack = std::stoul(args["B"]);
+	}
+
+	o.u_merge_level = std::stoi(args["F"]);
+	o.g_merge_level = std::stoi(args["G"]);
+	o.disj_merging = std::stoi(args["O"]);
+	o.parallel_portfolio = std::stoi(args["P"]);
+	o.relabel_aps = std::stoi(args["R"]);
+	o.x_single_succ = std::stoi(args["X"]);
+
+	if (args.count("T") > 0) {
+		o.deadline = std::stoul(args["T"]);
+	}
+
+	if (args.count("C") > 0) {
+		o.cache_dir = args["C"];
+	}
+
+	if (args.count("K") > 0) {
+		o.cache_size = std::stoul(args["K"]);
+	}
+
+	// -O1 implies -i1
+	o.single_init_state = o.single_init_state || o.disj_merging;
+
+	unsigned int print_phase = std::stoi(args["p"]);
+
+	// -p1 implies -l0
+	o.ltl_split = o.ltl_split && (print_phase & 2);
+
+	// -x2 implies -b1 (mind the bitwise operations)
+	if (o.debug & 2) {
+		o.try_ltl2tgba_spotela = o.try_ltl2tgba_spotela | 1;
+	}
+
+	return o;
+}
+
+void set_options(const translator_options& o) {
+	o_try_ltl2tgba_spotela = o.try_ltl2tgba_spotela;
+	o_slaa_trans_red = o.slaa_trans_red;
+	o_single_init_state = o.single_init_state;
+	o_slaa_determ = o.slaa_determ;
+	o_eq_level = o.eq_level;
+	o_ltl_split = o.ltl_split;
+	o_mergeable_info = o.mergeable_info;
+	o_try_negation = o.try_negation;
+	o_simplify_formula = o.simplify_formula;
+	o_ac_filter_fin = o.ac_filter_fin;
+	o_debug = o.debug;
+
+	o_bound_slack = o.bound_slack;
+	o_antichain = o.antichain;
+	o_deterministic = o.deterministic;
+
+	o_u_merge_level = o.u_merge_level;
+	o_g_merge_level = o.g_merge_level;
+	o_disj_merging = o.disj_merging;
+	o_parallel_portfolio = o.parallel_portfolio;
+	o_relabel_aps = o.relabel_aps;
+	o_x_single_succ = o.x_single_succ;
+
+	o_deadline = o.deadline;
+
+	o_cache_dir = o.cache_dir;
+	o_cache_size = o.cache_size;
+}
+
+void set_options(std::map<std::string, std::string>& args) {
+	set_options(options_from_arguments(args));
+}
+
+translator_options get_options() {
+	translator_options o;
+
+	o.try_ltl2tgba_spotela = o_try_ltl2tgba_spotela;
+	o.slaa_trans_red = o_slaa_trans_red;
+	o.single_init_state = o_single_init_state;
+	o.slaa_determ = o_slaa_determ;
+	o.eq_level = o_eq_level;
+	o.ltl_split = o_ltl_split;
+	o.mergeable_info = o_mergeable_info;
+	o.try_negation = o_try_negation;
+	o.simplify_formula = o_simplify_formula;
+	o.ac_filter_fin = o_ac_filter_fin;
+	o.debug = o_debug;
+
+	o.bound_slack = o_bound_slack;
+	o.antichain = o_antichain;
+	o.deterministic = o_deterministic;
+
+	o.u_merge_level = o_u_merge_level;
+	o.g_merge_level = o_g_merge_level;
+	o.disj_merging = o_disj_merging;
+	o.parallel_portfolio = o_parallel_portfolio;
+	o.relabel_aps = o_relabel_aps;
+	o.x_single_succ = o_x_single_succ;
+
+	o.deadline = o_deadline;
+
+	o.cache_dir = o_cache_dir;
+	o.cache_size = o_cache_size;
+
+	return o;
+}
+
 // the comparison now works as follows:
 // 1. return the smaller automaton (wrt. number of states)
 // 2. choose deterministic automaton
@@ -19,14 +19,19 @@
 
 #ifndef INTERFACES_H
 #define INTERFACES_H
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <climits>
+#include <cstdlib>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <string>
 #include <vector>
 #include <queue>
 #include <bddx.h>
+#define LTL3TELA_VERSION "2.1.1"
 #include <spot/tl/formula.hh>
 #include <spot/tl/parse.hh>
 #include <spot/tl/print.hh>
@@ -48,19 +53,86 @@ extern bool o_simplify_formula;		// -s
 extern bool o_ac_filter_fin;		// -t
 extern unsigned o_debug;			// -x
 
+extern bool o_antichain;			// -A
+extern unsigned o_bound_slack;		// -B
 extern bool o_deterministic;		// -D
 
 extern unsigned o_u_merge_level;	// -F
 extern unsigned o_g_merge_level;	// -G
 extern bool o_disj_merging;			// -O
+extern bool o_parallel_portfolio;	// -P
+extern bool o_relabel_aps;			// -R
 extern bool o_x_single_succ;		// -X
 
+extern unsigned o_deadline;			// -T, in ms
+
+extern std::string o_cache_dir;		// -C
+extern unsigned o_cache_size;		// -K
+
+// Spot orders the operands of commutative operators by the IDs of the formulae,
+// i.e. by the order of their creation, which depends on what else the process
+// translated; this order sorts them by their structure instead: first by
+// the string with anonymous APs, then by the string with their names
+class structural_order {
+	typedef std::pair<std::string, std::string> structure_key;
+	std::unordered_map<spot::formula, structure_key> keys;
+
+	const structure_key& get_key(spot::formula f);
+public:
+	// returns the operands of f, sorted if the operator is commutative
+	std::vector<spot::formula> operands(spot::formula f);
+
+	// returns a string of f that is the same in every process
+	const std::string& str(spot::formula f);
+};
+
 // returns the DNF representation of LTL formula f
 std::set<std::set<spot::formula>> f_bar(spot::formula f);
 
 // parses arguments from argv
 std::map<std::string, std::string> parse_arguments(int argc, char* argv[]);
 
+// all the o_* options in one structure; the defaults are those of the command line
+struct translator_options {
+	unsigned try_ltl2tgba_spotela = 3;	// -b
+	unsigned slaa_trans_red = 3;		// -c
+	bool single_init_state = false;		// -i
+	unsigned slaa_determ = 2;			// -d
+	unsigned eq_level = 2;				// -e
+	bool ltl_split = true;				// -l
+	unsigned mergeable_info = 0;		// -m
+	bool try_negation = true;			// -n
+	bool simplify_formula = true;		// -s
+	bool ac_filter_fin = true;			// -t
+	unsigned debug = 0;					// -x
+
+	bool antichain = false;				// -A
+	unsigned bound_slack = 0;			// -B, 0 if off
+	bool deterministic = false;			// -D
+
+	unsigned u_merge_level = 2;			// -F
+	unsigned g_merge_level = 2;			// -G
+	bool disj_merging = false;			// -O
+	bool parallel_portfolio = false;	// -P
+	bool relabel_aps = false;			// -R
+	bool x_single_succ = false;			// -X
+
+	unsigned deadline = 0;				// -T, in ms, 0 if none
+
+	std::string cache_dir = "";			// -C, empty if disabled
+	unsigned cache_size = 64;			// -K, in MiB
+};
+
+// converts the arguments returned by parse_arguments to options
+translator_options options_from_arguments(std::map<std::string, std::string>& args);
+
+// sets the o_* options
+void set_options(const translator_options& o);
+void set_options(std::map<std::string, std::string>& args);
+
+// returns the current values of the o_* options
+translator_options get_options();
+
 // return the better (smaller, more deterministic) of the two automata
 std::pair<spot::twa_graph_ptr, std::string> compare_automata(spot::twa_graph_ptr aut1, spot::twa_graph_ptr aut2, std::string stats_id1 = "", std::string stats_id2 = "");
 